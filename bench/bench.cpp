@@ -0,0 +1,30 @@
+#include "bench.hpp"
+#include <cstring>
+
+struct Suite {
+    const char* name;
+    void (*run)();
+};
+
+static const Suite suites[] = {
+    {"dispatch", dispatchBenchmarks},
+    {"variables", variableBenchmarks},
+    {"values", valueBenchmarks},
+    {"load", loadBenchmarks},
+    {"clones", cloneBenchmarks},
+    {"collision", collisionBenchmarks},
+};
+
+// bench [suite...] runs the named suites, or all of them
+int main(int argc, char** argv) {
+    for (const Suite& suite : suites) {
+        bool wanted = argc == 1;
+        for (int i = 1; i < argc; i++) {
+            if (strcmp(argv[i], suite.name) == 0) wanted = true;
+        }
+        if (!wanted) continue;
+        printf("== %s\n", suite.name);
+        suite.run();
+    }
+    return 0;
+}
@@ -0,0 +1,30 @@
+#pragma once
+#include <chrono>
+#include <cstdio>
+#include <string>
+
+// keeps the compiler from optimizing away a result nothing reads
+template <typename T>
+inline void keep(const T& value) {
+    asm volatile("" : : "g"(&value) : "memory");
+}
+
+// runs work(iterations) and prints how long one iteration took
+template <typename Work>
+double measure(const std::string& name, long iterations, Work work) {
+    auto start = std::chrono::steady_clock::now();
+    work(iterations);
+    std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    double perIteration = elapsed.count() / iterations;
+    if (perIteration >= 1000000) printf("%-44s %12.2f ms\n", name.c_str(), perIteration / 1000000);
+    else printf("%-44s %12.2f ns\n", name.c_str(), perIteration);
+    return perIteration;
+}
+
+// one per area. a benchmark prints its numbers, there is nothing to pass or fail
+void dispatchBenchmarks();
+void variableBenchmarks();
+void valueBenchmarks();
+void loadBenchmarks();
+void cloneBenchmarks();
+void collisionBenchmarks();
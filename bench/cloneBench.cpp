@@ -0,0 +1,48 @@
+#include "bench.hpp"
+#include "projectBuilder.hpp"
+#include "interpret.hpp"
+
+static void perSecond(const std::string& name, double nanoseconds) {
+    printf("%-44s %12.0f /s\n", name.c_str(), 1000000000.0 / nanoseconds);
+}
+
+// making and deleting clones straight through the pool, 100 a tick
+static void poolChurn() {
+    TargetBuilder stage("Stage", true);
+    TargetBuilder sprite("Sprite1");
+    Headless::start(buildProject({&stage, &sprite}));
+    Sprite* original = findOriginal(findSpriteId("Sprite1"));
+    std::vector<Sprite*> made;
+    double nanoseconds = measure("create and delete a clone", 1000000, [&](long iterations) {
+        for (long i = 0; i < iterations; i += 100) {
+            for (int j = 0; j < 100; j++) made.push_back(createClone(*original));
+            for (Sprite* clone : made) deleteClone(clone);
+            made.clear();
+            BlockExecutor::runRepeatBlocks();
+        }
+    });
+    perSecond("clone churn through the pool", nanoseconds);
+    Headless::stop();
+}
+
+// a spawner making 20 clones a tick that delete themselves the tick after, like bullets
+static void scriptChurn() {
+    TargetBuilder stage("Stage", true);
+    TargetBuilder sprite("Bullet");
+    std::string spawn = sprite.repeat(number(20), sprite.createCloneOfMyself());
+    sprite.script({sprite.defineProcedure("spawn", true), spawn});
+    sprite.script({sprite.whenFlagClicked(), sprite.forever(sprite.callProcedure("spawn", true))});
+    sprite.script({sprite.whenStartAsClone(), sprite.deleteThisClone()});
+    Headless::start(buildProject({&stage, &sprite}));
+    const int ticks = 5000;
+    double nanoseconds = measure("spawner tick, 20 clones", ticks, [&](long iterations) {
+        Headless::run(iterations);
+    });
+    perSecond("clone churn from scripts", nanoseconds / 20);
+    Headless::stop();
+}
+
+void cloneBenchmarks() {
+    poolChurn();
+    scriptChurn();
+}
@@ -0,0 +1,67 @@
+#include "bench.hpp"
+#include "projectBuilder.hpp"
+#include "interpret.hpp"
+#include "collisionMask.hpp"
+
+// 100 enemy clones and 200 bullet clones (300 is the clone limit) wandering the stage,
+// every bullet asking "touching Enemy?" every tick
+static nlohmann::json bulletHell(double turn) {
+    TargetBuilder stage("Stage", true);
+    TargetBuilder enemy("Enemy");
+    TargetBuilder bullet("Bullet");
+    BuiltVariable hits = stage.addVariable("hits");
+    for (TargetBuilder* sprite : {&enemy, &bullet}) {
+        double clones = sprite == &bullet ? 200 : 100;
+        sprite->script({sprite->defineProcedure("spawn", true), sprite->repeat(number(clones), sprite->createCloneOfMyself())});
+        sprite->script({sprite->whenFlagClicked(), sprite->callProcedure("spawn", true)});
+
+        std::string random = sprite->block("motion_goto_menu", {}, {{"TO", {"_random_", nullptr}}}, nullptr, true);
+        std::vector<std::string> body = {
+            sprite->block("motion_movesteps", {{"STEPS", number(3)}}),
+            sprite->block("motion_turnright", {{"DEGREES", number(turn)}}),
+            sprite->block("motion_ifonedgebounce"),
+        };
+        if (sprite == &bullet) {
+            std::string target = sprite->block("sensing_touchingobjectmenu", {}, {{"TOUCHINGOBJECTMENU", {"Enemy", nullptr}}}, nullptr, true);
+            std::string touching = sprite->block("sensing_touchingobject", {{"TOUCHINGOBJECTMENU", menu(target)}});
+            body.push_back(sprite->ifThen(touching, sprite->changeVariable(hits, number(1))));
+        }
+        sprite->script({sprite->whenStartAsClone(), sprite->block("motion_goto", {{"TO", menu(random)}}), sprite->forever(sprite->stack(body))});
+    }
+    return buildProject({&stage, &enemy, &bullet});
+}
+
+// a filled circle the size of the sprites, centered on the rotation center
+static void storeCircleMasks(int diameter) {
+    std::vector<unsigned char> rgba(diameter * diameter * 4, 0);
+    for (int y = 0; y < diameter; y++) {
+        for (int x = 0; x < diameter; x++) {
+            double dx = x + 0.5 - diameter / 2.0;
+            double dy = y + 0.5 - diameter / 2.0;
+            if (dx * dx + dy * dy <= diameter * diameter / 4.0) rgba[(y * diameter + x) * 4 + 3] = 255;
+        }
+    }
+    for (Sprite* sprite : sprites) {
+        for (Costume& costume : sprite->shared->costumes) {
+            storeCollisionMask(costume.id, rgba.data(), diameter, diameter, diameter * 4);
+            costume.rotationCenterX = costume.rotationCenterY = diameter / 2.0;
+        }
+    }
+}
+
+static void bulletTicks(const std::string& name, double turn, bool masks) {
+    Headless::start(bulletHell(turn));
+    for (Sprite* sprite : sprites) sprite->spriteWidth = sprite->spriteHeight = 16;
+    if (masks) storeCircleMasks(16);
+    Headless::run(2); // make the clones
+    measure(name, 500, [&](long iterations) {
+        Headless::run(iterations);
+    });
+    Headless::stop();
+}
+
+void collisionBenchmarks() {
+    bulletTicks("bullet hell tick, boxes", 2, false);
+    bulletTicks("bullet hell tick, masks", 0, true);
+    bulletTicks("bullet hell tick, masks, turning", 2, true);
+}
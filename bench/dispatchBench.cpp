@@ -0,0 +1,156 @@
+#include "bench.hpp"
+#include "projectBuilder.hpp"
+#include "interpret.hpp"
+#include "blocks/motion.hpp"
+#include "blocks/looks.hpp"
+#include "blocks/data.hpp"
+#include "blocks/operator.hpp"
+#include <functional>
+#include <unordered_map>
+
+// the handlers compared between the two kinds of table
+#define COMPARED_STATEMENTS(X) \
+    X(MOTION_CHANGEXBY, MotionBlocks::changeXBy) \
+    X(MOTION_CHANGEYBY, MotionBlocks::changeYBy) \
+    X(MOTION_TURNRIGHT, MotionBlocks::turnRight) \
+    X(LOOKS_SHOW, LooksBlocks::show) \
+    X(DATA_SETVARIABLETO, DataBlocks::setVariable) \
+    X(DATA_CHANGEVARIABLEBY, DataBlocks::changeVariable)
+
+#define COMPARED_REPORTERS(X) \
+    X(OPERATOR_ADD, OperatorBlocks::add) \
+    X(OPERATOR_SUBTRACT, OperatorBlocks::subtract) \
+    X(OPERATOR_MULTIPLY, OperatorBlocks::multiply) \
+    X(OPERATOR_EQUALS, OperatorBlocks::equals)
+
+// calls a statement handler the way the executor does
+template <typename Handler>
+static BlockResult runStatement(const Handler& handler, Block& block, Sprite* sprite) {
+    Thread thread{sprite, sprite->generation, &block};
+    return handler(block, sprite, &thread);
+}
+
+// runs the project to the end and prints the time per block run. the green flag can run
+// scripts right away, so loading the (small) project is timed too
+static void timePerBlock(const std::string& name, const nlohmann::json& project) {
+    auto start = std::chrono::steady_clock::now();
+    blocksRun = 0;
+    Headless::start(project);
+    size_t blocks = blocksRun;
+    int ticks = Headless::run(100000, &blocks);
+    std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    Headless::stop();
+    printf("%-44s %12.2f ns  (%zu blocks, %d ticks)\n", name.c_str(), elapsed.count() / blocks, blocks, ticks);
+}
+
+// a warp custom block looping over a few statements and reporters, so nearly all the time is dispatch
+static nlohmann::json warpLoop() {
+    TargetBuilder stage("Stage", true);
+    TargetBuilder sprite("Sprite1");
+    BuiltVariable counter = sprite.addVariable("counter");
+    BuiltVariable total = sprite.addVariable("total");
+    std::string sum = sprite.block("operator_add", {{"NUM1", variable(counter)}, {"NUM2", variable(total)}});
+    std::string body = sprite.stack({
+        sprite.changeVariable(counter, number(1)),
+        sprite.setVariable(total, reporter(sum)),
+        sprite.block("motion_changexby", {{"DX", number(1)}}),
+    });
+    sprite.script({sprite.defineProcedure("spin", true), sprite.repeat(number(200000), body)});
+    sprite.script({sprite.whenFlagClicked(), sprite.callProcedure("spin", true)});
+    return buildProject({&stage, &sprite});
+}
+
+// many scripts yielding every tick, so the scheduler's part of the cost shows
+static nlohmann::json yieldingLoops() {
+    TargetBuilder stage("Stage", true);
+    std::vector<TargetBuilder> sprites;
+    for (int i = 0; i < 50; i++) {
+        TargetBuilder& sprite = sprites.emplace_back("Sprite" + std::to_string(i));
+        BuiltVariable counter = sprite.addVariable("counter");
+        sprite.script({sprite.whenFlagClicked(), sprite.repeat(number(2000), sprite.changeVariable(counter, number(1)))});
+    }
+    std::vector<const TargetBuilder*> targets = {&stage};
+    for (const TargetBuilder& sprite : sprites) targets.push_back(&sprite);
+    return buildProject(targets);
+}
+
+// one of each compared block. the script never runs, the blocks are only handed to the handlers
+static nlohmann::json comparedBlocks() {
+    TargetBuilder stage("Stage", true);
+    TargetBuilder sprite("Sprite1");
+    BuiltVariable counter = sprite.addVariable("counter");
+    std::vector<std::string> statements = {
+        sprite.block("motion_changexby", {{"DX", number(1)}}),
+        sprite.block("motion_changeyby", {{"DY", number(1)}}),
+        sprite.block("motion_turnright", {{"DEGREES", number(1)}}),
+        sprite.block("looks_show"),
+        sprite.setVariable(counter, number(1)),
+        sprite.changeVariable(counter, number(1)),
+    };
+    sprite.block("operator_add", {{"NUM1", number(1)}, {"NUM2", number(2)}});
+    sprite.block("operator_subtract", {{"NUM1", number(1)}, {"NUM2", number(2)}});
+    sprite.block("operator_multiply", {{"NUM1", number(3)}, {"NUM2", number(2)}});
+    sprite.block("operator_equals", {{"OPERAND1", number(1)}, {"OPERAND2", number(2)}});
+    sprite.script(statements);
+    return buildProject({&stage, &sprite});
+}
+
+// the same blocks looked up the way handlers were before the dense tables, in an
+// unordered_map of std::function, and through an array indexed by opcode
+static void tableComparison() {
+    using MapStatementHandler = std::function<std::remove_pointer_t<BlockHandler>>;
+    using MapValueHandler = std::function<std::remove_pointer_t<ValueHandler>>;
+    std::unordered_map<Block::opCode, MapStatementHandler> statementMap;
+    std::unordered_map<Block::opCode, MapValueHandler> valueMap;
+    BlockHandler statementTable[Block::OPCODE_COUNT] = {};
+    ValueHandler valueTable[Block::OPCODE_COUNT] = {};
+#define X(opcode, handler) statementMap[Block::opcode] = handler; statementTable[Block::opcode] = handler;
+    COMPARED_STATEMENTS(X)
+#undef X
+#define X(opcode, handler) valueMap[Block::opcode] = handler; valueTable[Block::opcode] = handler;
+    COMPARED_REPORTERS(X)
+#undef X
+
+    Headless::start(comparedBlocks());
+    Sprite* sprite = sprites.back();
+    std::vector<Block*> statements;
+    std::vector<Block*> reporters;
+    for (auto& [id, block] : sprite->shared->blocks) {
+        if (statementTable[block.opcode] != nullptr) statements.push_back(&block);
+        if (valueTable[block.opcode] != nullptr) reporters.push_back(&block);
+    }
+
+    measure("statement, unordered_map<std::function>", 10000000, [&](long iterations) {
+        for (long i = 0; i < iterations; i++) {
+            Block& block = *statements[i % statements.size()];
+            auto handler = statementMap.find(block.opcode);
+            if (handler != statementMap.end()) keep(runStatement(handler->second, block, sprite));
+        }
+    });
+    measure("statement, dense table", 10000000, [&](long iterations) {
+        for (long i = 0; i < iterations; i++) {
+            Block& block = *statements[i % statements.size()];
+            BlockHandler handler = statementTable[block.opcode];
+            if (handler != nullptr) keep(runStatement(handler, block, sprite));
+        }
+    });
+    measure("reporter, unordered_map<std::function>", 10000000, [&](long iterations) {
+        for (long i = 0; i < iterations; i++) {
+            Block& block = *reporters[i % reporters.size()];
+            auto handler = valueMap.find(block.opcode);
+            if (handler != valueMap.end()) keep(handler->second(block, sprite));
+        }
+    });
+    measure("reporter, executor's dense table", 10000000, [&](long iterations) {
+        for (long i = 0; i < iterations; i++) {
+            keep(executor.getBlockValue(*reporters[i % reporters.size()], sprite));
+        }
+    });
+    Headless::stop();
+}
+
+void dispatchBenchmarks() {
+    tableComparison();
+    timePerBlock("warp loop, per block", warpLoop());
+    timePerBlock("50 yielding loops, per block", yieldingLoops());
+}
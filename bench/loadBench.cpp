@@ -0,0 +1,65 @@
+#include "bench.hpp"
+#include "projectBuilder.hpp"
+#include "interpret.hpp"
+
+// a project shaped like a big game: many sprites with many scripts mixing statements,
+// reporters, menus and opcodes the interpreter doesn't support
+static nlohmann::json bigProject(int spriteCount, int scriptsPerSprite) {
+    std::vector<TargetBuilder> targets;
+    targets.emplace_back("Stage", true);
+    BuiltVariable score = targets.front().addVariable("score");
+    for (int s = 0; s < spriteCount; s++) {
+        TargetBuilder& sprite = targets.emplace_back("Sprite" + std::to_string(s));
+        BuiltVariable speed = sprite.addVariable("speed", 3);
+        for (int i = 0; i < scriptsPerSprite; i++) {
+            std::string product = sprite.block("operator_multiply", {{"NUM1", variable(speed)}, {"NUM2", number(i)}});
+            std::string sum = sprite.block("operator_add", {{"NUM1", reporter(product)}, {"NUM2", variable(score)}});
+            std::string touching = sprite.block("sensing_touchingobjectmenu", {}, {{"TOUCHINGOBJECTMENU", {"_edge_", nullptr}}}, nullptr, true);
+            std::string isTouching = sprite.block("sensing_touchingobject", {{"TOUCHINGOBJECTMENU", menu(touching)}});
+            std::string body = sprite.stack({
+                sprite.block("motion_changexby", {{"DX", reporter(sum)}}),
+                sprite.ifThen(isTouching, sprite.block("motion_ifonedgebounce")),
+                sprite.changeVariable(score, number(1)),
+                sprite.block("pen_penDown"),
+                sprite.block("looks_nextcostume"),
+            });
+            sprite.script({sprite.whenFlagClicked(), sprite.forever(body)});
+        }
+    }
+    std::vector<const TargetBuilder*> pointers;
+    for (const TargetBuilder& target : targets) pointers.push_back(&target);
+    return buildProject(pointers);
+}
+
+void loadBenchmarks() {
+    nlohmann::json project = bigProject(100, 50);
+    std::string saved = project.dump();
+
+    size_t blocks = 0;
+    for (const auto& target : project["targets"]) blocks += target["blocks"].size();
+    printf("synthetic project: %zu blocks, %zu bytes\n", blocks, saved.size());
+
+    measure("parse project.json", 5, [&](long iterations) {
+        for (long i = 0; i < iterations; i++) {
+            nlohmann::json parsed = nlohmann::json::parse(saved);
+            keep(parsed);
+        }
+    });
+    measure("loadSprites", 5, [&](long iterations) {
+        for (long i = 0; i < iterations; i++) {
+            projectType = EMBEDDED;
+            loadSprites(project);
+            cleanupSprites();
+        }
+    });
+
+    std::vector<std::string> opcodes;
+    for (const auto& target : project["targets"]) {
+        for (const auto& [id, block] : target["blocks"].items()) opcodes.push_back(block["opcode"]);
+    }
+    measure("stringToOpcode", 20 * opcodes.size(), [&](long iterations) {
+        for (long i = 0; i < iterations; i++) {
+            keep(Block::stringToOpcode(opcodes[i % opcodes.size()]));
+        }
+    });
+}
@@ -0,0 +1,78 @@
+#include "bench.hpp"
+#include "value.hpp"
+#include <vector>
+
+// values of one kind to cycle through, so nothing is known at compile time
+static std::vector<Value> valuesOf(int kind) {
+    std::vector<Value> values;
+    for (int i = 0; i < 64; i++) {
+        switch (kind) {
+            case 0: values.push_back(Value(i)); break;
+            case 1: values.push_back(Value(i + 0.5)); break;
+            case 2: values.push_back(Value(std::to_string(i))); break;
+            case 3: values.push_back(Value("a string too long for any small string buffer " + std::to_string(i))); break;
+        }
+    }
+    return values;
+}
+
+static void copies(const char* name, const std::vector<Value>& values) {
+    measure(std::string("copy ") + name, 20000000, [&](long iterations) {
+        for (long i = 0; i < iterations; i++) {
+            Value copy = values[i & 63];
+            keep(copy);
+        }
+    });
+}
+
+template <typename Operation>
+static void pairs(const std::string& name, const std::vector<Value>& left, const std::vector<Value>& right, Operation operation) {
+    measure(name, 10000000, [&](long iterations) {
+        for (long i = 0; i < iterations; i++) {
+            auto result = operation(left[i & 63], right[(i * 7) & 63]);
+            keep(result);
+        }
+    });
+}
+
+void valueBenchmarks() {
+    std::vector<Value> integers = valuesOf(0);
+    std::vector<Value> doubles = valuesOf(1);
+    std::vector<Value> numericStrings = valuesOf(2);
+    std::vector<Value> longStrings = valuesOf(3);
+
+    copies("integer", integers);
+    copies("double", doubles);
+    copies("short string", numericStrings);
+    copies("long string", longStrings);
+    measure("move long string", 20000000, [&](long iterations) {
+        Value held = longStrings[0];
+        for (long i = 0; i < iterations; i++) {
+            Value moved = std::move(held);
+            held = std::move(moved);
+        }
+        keep(held);
+    });
+
+    auto add = [](const Value& a, const Value& b) { return a + b; };
+    auto multiply = [](const Value& a, const Value& b) { return a * b; };
+    pairs("add integers", integers, integers, add);
+    pairs("add doubles", doubles, doubles, add);
+    pairs("add integer to numeric string", integers, numericStrings, add);
+    pairs("multiply numeric strings", numericStrings, numericStrings, multiply);
+
+    auto equals = [](const Value& a, const Value& b) { return a == b; };
+    auto less = [](const Value& a, const Value& b) { return a < b; };
+    pairs("equals integers", integers, integers, equals);
+    pairs("equals integer and numeric string", integers, numericStrings, equals);
+    pairs("equals long strings", longStrings, longStrings, equals);
+    pairs("less than doubles", doubles, doubles, less);
+    pairs("less than long strings", longStrings, longStrings, less);
+
+    measure("double as string", 2000000, [&](long iterations) {
+        for (long i = 0; i < iterations; i++) {
+            std::string text = doubles[i & 63].asString();
+            keep(text);
+        }
+    });
+}
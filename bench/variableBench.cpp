@@ -0,0 +1,38 @@
+#include "bench.hpp"
+#include "projectBuilder.hpp"
+#include "interpret.hpp"
+
+// reading a stage variable from a sprite shouldn't get slower as clones are made
+static void globalReads(int clones) {
+    TargetBuilder stage("Stage", true);
+    TargetBuilder sprite("Sprite1");
+    BuiltVariable score = stage.addVariable("score", 10);
+    sprite.script({sprite.whenFlagClicked(), sprite.repeat(number(clones), sprite.createCloneOfMyself())});
+    Headless::start(buildProject({&stage, &sprite}));
+    Headless::run(clones + 10);
+    Sprite* reader = findOriginal(findSpriteId("Sprite1"));
+
+    std::string suffix = ", " + std::to_string(clones) + " clones";
+    measure("getVariableValue of a global" + suffix, 5000000, [&](long iterations) {
+        for (long i = 0; i < iterations; i++) {
+            Value value = getVariableValue(score.id, reader);
+            keep(value);
+        }
+    });
+    // what a compiled block does, its ref is resolved once at load
+    VariableRef resolved = resolveVariable(score.id, reader);
+    measure("resolved global read" + suffix, 50000000, [&](long iterations) {
+        for (long i = 0; i < iterations; i++) {
+            Value value = variableValue(resolved, reader);
+            keep(value);
+        }
+    });
+    printf("(%zu sprites)\n", sprites.size());
+    Headless::stop();
+}
+
+void variableBenchmarks() {
+    globalReads(0);
+    globalReads(100);
+    globalReads(299);
+}
@@ -13,6 +13,7 @@
 #define NANOSVGRAST_IMPLEMENTATION
 #include "nanosvgrast.h"
 #include "../scratch/unzip.hpp"
+#include "../scratch/collisionMask.hpp"
 
 using u32 = uint32_t;
 using u8 = uint8_t;
@@ -84,6 +85,7 @@ for (int i = 0; i < file_count; i++) {
 
         int width, height, channels;
         unsigned char* rgba_data = nullptr;
+        float maskScale = 1.0f;
         
         // Check if this is an SVG file
         if (zipFileName.substr(zipFileName.size() - 4) == ".svg" || zipFileName.substr(zipFileName.size() - 4) == ".SVG") {
@@ -113,6 +115,7 @@ for (int i = 0; i < file_count; i++) {
                         
                         // Rasterize SVG to RGBA
                         nsvgRasterize(rast, svg_image, 0, 0, scale, rgba_data, width, height, width * 4);
+                        maskScale = scale;
                         printf("Successfully rasterized SVG: %s (%dx%d)\n", zipFileName.c_str(), width, height);
                     }
                     nsvgDeleteRasterizer(rast);
@@ -138,6 +141,7 @@ for (int i = 0; i < file_count; i++) {
         newRGBA.width = width;
         newRGBA.height = height;
         newRGBA.data = rgba_data;
+        storeCollisionMask(newRGBA.name, rgba_data, width, height, width * 4, maskScale);
 
         size_t imageSize = width * height * 4;
         memStats.totalRamUsage += imageSize;
@@ -158,6 +162,7 @@ void Image::loadImageFromFile(std::string filePath){
     
   int width,height,channels;
   unsigned char* rgba_data = nullptr;
+  float maskScale = 1.0f;
   
   // Try SVG first
   FILE* file = fopen(("romfs:/project/"+filePath + ".svg").c_str(), "rb");
@@ -198,6 +203,7 @@ void Image::loadImageFromFile(std::string filePath){
             
             // Rasterize SVG to RGBA
             nsvgRasterize(rast, svg_image, 0, 0, scale, rgba_data, width, height, width * 4);
+            maskScale = scale;
             printf("Successfully rasterized SVG file: %s (%dx%d)\n", filePath.c_str(), width, height);
           }
           nsvgDeleteRasterizer(rast);
@@ -233,6 +239,7 @@ void Image::loadImageFromFile(std::string filePath){
     newRGBA.width = width;
     newRGBA.height = height;
     newRGBA.data = rgba_data;
+    storeCollisionMask(filePath, rgba_data, width, height, width * 4, maskScale);
     //memorySize += sizeof(newRGBA);
 
     size_t imageSize = width * height * 4;
@@ -7,12 +7,11 @@
 #define BOTTOM_SCREEN_WIDTH 320
 #define SCREEN_HEIGHT 240
 
-std::vector<std::string> Input::inputButtons;
 Input::Mouse Input::mousePointer;
 int keyHeldFrames = 0;
 
 void Input::getInput(){
-    inputButtons.clear();
+    KeySet held;
     mousePointer.isPressed = false;
     mousePointer.isMoving = false;
     hidScanInput();
@@ -26,88 +25,87 @@ void Input::getInput(){
 
     if(kDown){
         keyHeldFrames += 1;
-        inputButtons.push_back("any");
         if(kDown & KEY_A){
-            inputButtons.push_back("a");
+            held.set(static_cast<int>(Key::A));
         }
         if(kDown & KEY_B){
-            inputButtons.push_back("b");
+            held.set(static_cast<int>(Key::B));
         }
         if(kDown & KEY_X){
-            inputButtons.push_back("x");
+            held.set(static_cast<int>(Key::X));
         }
         if(kDown & KEY_Y){
-            inputButtons.push_back("y");
+            held.set(static_cast<int>(Key::Y));
         }
         if(kDown & KEY_SELECT){
-            inputButtons.push_back("0");
+            held.set(static_cast<int>(Key::DIGIT_0));
         }
         if(kDown & KEY_START){
-            inputButtons.push_back("1");
+            held.set(static_cast<int>(Key::DIGIT_1));
         }
         if(kDown & KEY_DUP){
             if(kDown & KEY_L)
             mousePointer.y += 3;
             else
-            inputButtons.push_back("u");
+            held.set(static_cast<int>(Key::U));
         }
         if(kDown & KEY_DDOWN){
             if(kDown & KEY_L)
             mousePointer.y -= 3;
             else
-            inputButtons.push_back("h");
+            held.set(static_cast<int>(Key::H));
         }
         if(kDown & KEY_DLEFT){
             if(kDown & KEY_L)
             mousePointer.x -= 3;
             else
-            inputButtons.push_back("g");
+            held.set(static_cast<int>(Key::G));
         }
         if(kDown & KEY_DRIGHT){
             if(kDown & KEY_L)
             mousePointer.x += 3;
             else
-            inputButtons.push_back("j");
+            held.set(static_cast<int>(Key::J));
         }
         if(kDown & KEY_L){
-            inputButtons.push_back("l");
+            held.set(static_cast<int>(Key::L));
             mousePointer.isMoving = true;
         }
         if(kDown & KEY_R){
             if(kDown & KEY_L)
             mousePointer.isPressed = true;
             else
-            inputButtons.push_back("r");
+            held.set(static_cast<int>(Key::R));
         }
         if(kDown & KEY_ZL){
-            inputButtons.push_back("z");
+            held.set(static_cast<int>(Key::Z));
         }
         if(kDown & KEY_ZR){
-            inputButtons.push_back("f");
+            held.set(static_cast<int>(Key::F));
         }
         if(kDown & KEY_CPAD_UP){
-            inputButtons.push_back("up arrow");
+            held.set(static_cast<int>(Key::UP_ARROW));
         }
         if(kDown & KEY_CPAD_DOWN){
-            inputButtons.push_back("down arrow");
+            held.set(static_cast<int>(Key::DOWN_ARROW));
         }
         if(kDown & KEY_CPAD_LEFT){
-            inputButtons.push_back("left arrow");
+            held.set(static_cast<int>(Key::LEFT_ARROW));
         }
         if(kDown & KEY_CPAD_RIGHT){
-            inputButtons.push_back("right arrow");
+            held.set(static_cast<int>(Key::RIGHT_ARROW));
         }
         if(kDown & KEY_CSTICK_UP){
-            inputButtons.push_back("2");
+            held.set(static_cast<int>(Key::DIGIT_2));
         }
         if(kDown & KEY_CSTICK_DOWN){
-            inputButtons.push_back("3");
+            held.set(static_cast<int>(Key::DIGIT_3));
         }
         if(kDown & KEY_CSTICK_LEFT){
-            inputButtons.push_back("4");
+            held.set(static_cast<int>(Key::DIGIT_4));
         }
         if(kDown & KEY_CSTICK_RIGHT){
-            inputButtons.push_back("5");
+            held.set(static_cast<int>(Key::DIGIT_5));
         }
         if(kDown & KEY_TOUCH){
             mousePointer.isPressed = true;
@@ -117,12 +115,17 @@ void Input::getInput(){
             else
             mousePointer.y = (-touch.py + (SCREEN_HEIGHT)) -SCREEN_HEIGHT / 2;
         }
-        if (keyHeldFrames == 1 || keyHeldFrames > 30)
-        BlockExecutor::runAllBlocksByOpcode(Block::EVENT_WHEN_KEY_PRESSED);
     }
     else{
         keyHeldFrames = 0;
     }
+    setKeys(held);
+
+    // keys fire when they go down, and after being held for a while they keep firing like a key repeat
+    if (keyHeldFrames > 30)
+    BlockExecutor::runKeyPressedHats(keysHeld);
+    else
+    BlockExecutor::runKeyPressedHats(keysPressed);
 
 
 }
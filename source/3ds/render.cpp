@@ -7,6 +7,7 @@
 #include "../scratch/input.hpp"
 #include "../scratch/image.hpp"
 #include "../scratch/render.hpp"
+#include "../scratch/collisionMask.hpp"
 
 #define SCREEN_WIDTH 400
 #define BOTTOM_SCREEN_WIDTH 320
@@ -201,7 +202,7 @@ void Render::renderSprites(){
     
     // look through every costume in sprite for correct one
         int costumeIndex = 0;
-        for(const auto& costume : currentSprite->costumes) {
+        for(const auto& costume : currentSprite->shared->costumes) {
             if(costumeIndex == currentSprite->currentCostume) {
                 currentSprite->rotationCenterX = costume.rotationCenterX;
                 currentSprite->rotationCenterY = costume.rotationCenterY;
@@ -228,7 +229,7 @@ void Render::renderSprites(){
         
         // look through every costume in sprite for correct one
         int costumeIndex = 0;
-        for(const auto& costume : currentSprite->costumes) {
+        for(const auto& costume : currentSprite->shared->costumes) {
             if(costumeIndex == currentSprite->currentCostume) {
                 currentSprite->rotationCenterX = costume.rotationCenterX;
                 currentSprite->rotationCenterY = costume.rotationCenterY;
@@ -439,6 +440,7 @@ void Render::deInit(){
         }
     }
     Image::imageRGBAS.clear();
+    clearCollisionMasks();
 
     romfsExit();
 	gfxExit();
@@ -0,0 +1,35 @@
+#include "../scratch/render.hpp"
+#include "../scratch/image.hpp"
+#include "../scratch/input.hpp"
+#include "../scratch/keyboard.hpp"
+#include "../sdl/audio.hpp"
+
+// a platform with no window, input or sound, so the benchmarks and checks can run the
+// interpreter on their own. nothing here is built into the app
+
+Render::RenderModes Render::renderMode = Render::TOP_SCREEN_ONLY;
+
+std::vector<Image::ImageRGBA> Image::imageRGBAS;
+void Image::loadImageFromFile(std::string filePath) {}
+void Image::loadImages(mz_zip_archive* zip) {}
+
+Input::Mouse Input::mousePointer;
+void Input::getInput() {}
+std::string Input::getUsername() {
+    return "Player";
+}
+
+std::string Keyboard::openKeyboard(const char* hintText) {
+    return "";
+}
+
+bool Audio::initialized = false;
+int Audio::nextTrackId = 0;
+int Audio::loadWAV(const void* data, size_t size) {
+    return -1;
+}
+void Audio::playTrack(int trackId, bool loop) {}
+void Audio::stopAllTracks() {}
+bool Audio::isTrackPlaying(int trackId) {
+    return false;
+}
@@ -0,0 +1,210 @@
+#include "projectBuilder.hpp"
+#include "../scratch/interpret.hpp"
+#include <sstream>
+
+BuiltInput number(double value){
+    std::ostringstream saved;
+    saved.precision(15); // the default 6 digits would save big counts like 1e+08
+    saved << value;
+    return {{1, {4, saved.str()}}, ""};
+}
+
+BuiltInput text(const std::string& value){
+    return {{1, {10, value}}, ""};
+}
+
+BuiltInput reporter(const std::string& blockId){
+    return {{3, blockId, {10, ""}}, blockId};
+}
+
+BuiltInput condition(const std::string& blockId){
+    return {{2, blockId}, blockId};
+}
+
+BuiltInput substack(const std::string& blockId){
+    if(blockId.empty()) return {{2, nullptr}, ""};
+    return {{2, blockId}, blockId};
+}
+
+BuiltInput menu(const std::string& shadowId){
+    return {{1, shadowId}, shadowId};
+}
+
+BuiltInput variable(const BuiltVariable& variable){
+    return {{3, {12, variable.name, variable.id}, {10, ""}}, ""};
+}
+
+// ids are unique across the project, like the editor's
+static int nextId = 0;
+
+TargetBuilder::TargetBuilder(const std::string& name, bool isStage) : name(name), isStage(isStage) {}
+
+BuiltVariable TargetBuilder::addVariable(const std::string& variableName, const nlohmann::json& value){
+    BuiltVariable added{variableName, "var" + std::to_string(nextId++)};
+    variables[added.id] = {variableName, value};
+    return added;
+}
+
+BuiltVariable TargetBuilder::addList(const std::string& listName, const nlohmann::json& items){
+    BuiltVariable added{listName, "list" + std::to_string(nextId++)};
+    lists[added.id] = {listName, items};
+    return added;
+}
+
+std::string TargetBuilder::block(const std::string& opcode, const BuiltInputs& inputs, const nlohmann::json& fields,
+                                 const nlohmann::json& mutation, bool shadow){
+    std::string id = "block" + std::to_string(nextId++);
+    nlohmann::json& added = blocks[id];
+    added = {{"opcode", opcode}, {"next", nullptr}, {"parent", nullptr}, {"inputs", nlohmann::json::object()},
+             {"fields", fields}, {"shadow", shadow}, {"topLevel", false}};
+    if(!mutation.is_null()) added["mutation"] = mutation;
+    for(const auto& [inputName, input] : inputs){
+        added["inputs"][inputName] = input.json;
+        if(!input.child.empty()) blocks[input.child]["parent"] = id;
+    }
+    return id;
+}
+
+std::string TargetBuilder::stack(const std::vector<std::string>& blockIds){
+    for(size_t i = 1; i < blockIds.size(); i++){
+        blocks[blockIds[i - 1]]["next"] = blockIds[i];
+        blocks[blockIds[i]]["parent"] = blockIds[i - 1];
+    }
+    return blockIds.empty() ? "" : blockIds.front();
+}
+
+std::string TargetBuilder::script(const std::vector<std::string>& blockIds){
+    std::string hat = stack(blockIds);
+    blocks[hat]["topLevel"] = true;
+    blocks[hat]["x"] = 0;
+    blocks[hat]["y"] = 0;
+    return hat;
+}
+
+std::string TargetBuilder::whenFlagClicked(){
+    return block("event_whenflagclicked");
+}
+
+std::string TargetBuilder::setVariable(const BuiltVariable& variable, const BuiltInput& value){
+    return block("data_setvariableto", {{"VALUE", value}}, {{"VARIABLE", {variable.name, variable.id}}});
+}
+
+std::string TargetBuilder::changeVariable(const BuiltVariable& variable, const BuiltInput& value){
+    return block("data_changevariableby", {{"VALUE", value}}, {{"VARIABLE", {variable.name, variable.id}}});
+}
+
+std::string TargetBuilder::repeat(const BuiltInput& times, const std::string& body){
+    return block("control_repeat", {{"TIMES", times}, {"SUBSTACK", substack(body)}});
+}
+
+std::string TargetBuilder::forever(const std::string& body){
+    return block("control_forever", {{"SUBSTACK", substack(body)}});
+}
+
+std::string TargetBuilder::ifThen(const std::string& conditionId, const std::string& body){
+    return block("control_if", {{"CONDITION", condition(conditionId)}, {"SUBSTACK", substack(body)}});
+}
+
+std::string TargetBuilder::equals(const BuiltInput& a, const BuiltInput& b){
+    return block("operator_equals", {{"OPERAND1", a}, {"OPERAND2", b}});
+}
+
+std::string TargetBuilder::stopThisScript(){
+    nlohmann::json mutation = {{"tagName", "mutation"}, {"children", nlohmann::json::array()}, {"hasnext", "false"}};
+    return block("control_stop", {}, {{"STOP_OPTION", {"this script", nullptr}}}, mutation);
+}
+
+std::string TargetBuilder::createCloneOfMyself(){
+    std::string option = block("control_create_clone_of_menu", {}, {{"CLONE_OPTION", {"_myself_", nullptr}}}, nullptr, true);
+    return block("control_create_clone_of", {{"CLONE_OPTION", menu(option)}});
+}
+
+std::string TargetBuilder::whenStartAsClone(){
+    return block("control_start_as_clone");
+}
+
+std::string TargetBuilder::deleteThisClone(){
+    return block("control_delete_this_clone");
+}
+
+std::string TargetBuilder::broadcast(const std::string& message){
+    broadcasts["broadcast" + message] = message;
+    return block("event_broadcast", {{"BROADCAST_INPUT", {{1, {11, message, "broadcast" + message}}, ""}}});
+}
+
+std::string TargetBuilder::whenIReceive(const std::string& message){
+    broadcasts["broadcast" + message] = message;
+    return block("event_whenbroadcastreceived", {}, {{"BROADCAST_OPTION", {message, "broadcast" + message}}});
+}
+
+std::string TargetBuilder::defineProcedure(const std::string& proccode, bool warp){
+    nlohmann::json mutation = {{"tagName", "mutation"}, {"children", nlohmann::json::array()}, {"proccode", proccode},
+                               {"argumentids", "[]"}, {"argumentnames", "[]"}, {"argumentdefaults", "[]"},
+                               {"warp", warp ? "true" : "false"}};
+    std::string prototype = block("procedures_prototype", {}, nlohmann::json::object(), mutation, true);
+    return block("procedures_definition", {{"custom_block", menu(prototype)}});
+}
+
+std::string TargetBuilder::callProcedure(const std::string& proccode, bool warp){
+    nlohmann::json mutation = {{"tagName", "mutation"}, {"children", nlohmann::json::array()}, {"proccode", proccode},
+                               {"argumentids", "[]"}, {"warp", warp ? "true" : "false"}};
+    return block("procedures_call", {}, nlohmann::json::object(), mutation);
+}
+
+void TargetBuilder::addComment(const std::string& commentText){
+    comments["comment" + std::to_string(nextId++)] = {{"blockId", nullptr}, {"x", 0}, {"y", 0}, {"width", 200}, {"height", 200},
+                                                     {"minimized", false}, {"text", commentText}};
+}
+
+nlohmann::json TargetBuilder::toJson(int layerOrder) const {
+    nlohmann::json costume = {{"assetId", name + "costume"}, {"name", "costume1"}, {"md5ext", name + "costume.svg"},
+                              {"dataFormat", "svg"}, {"bitmapResolution", 1}, {"rotationCenterX", 0}, {"rotationCenterY", 0}};
+    return {{"isStage", isStage}, {"name", name}, {"variables", variables}, {"lists", lists},
+            {"broadcasts", broadcasts}, {"blocks", blocks}, {"comments", comments}, {"currentCostume", 0},
+            {"costumes", {costume}}, {"sounds", nlohmann::json::array()}, {"volume", 100}, {"layerOrder", layerOrder},
+            {"visible", visible}, {"x", x}, {"y", y}, {"size", size}, {"direction", direction}, {"draggable", false},
+            {"rotationStyle", "all around"}};
+}
+
+nlohmann::json buildProject(const std::vector<const TargetBuilder*>& targets){
+    nlohmann::json project = {{"targets", nlohmann::json::array()}, {"monitors", nlohmann::json::array()},
+                              {"extensions", nlohmann::json::array()}, {"meta", {{"semver", "3.0.0"}}}};
+    for(size_t i = 0; i < targets.size(); i++){
+        project["targets"].push_back(targets[i]->toJson(i));
+    }
+    return project;
+}
+
+namespace Headless {
+
+void start(const nlohmann::json& project){
+    toExit = false;
+    projectType = EMBEDDED;
+    loadSprites(project);
+    BlockExecutor::timer = std::chrono::high_resolution_clock::now();
+    BlockExecutor::runAllBlocksByOpcode(Block::EVENT_WHENFLAGCLICKED);
+}
+
+int run(int maxTicks, size_t* blocksCounted){
+    int ticks = 0;
+    while(ticks < maxTicks && !toExit && !BlockExecutor::threads.empty()){
+        BlockExecutor::startFrame();
+        BlockExecutor::runRepeatBlocks();
+        if(blocksCounted != nullptr) *blocksCounted += blocksRun;
+        ticks++;
+    }
+    return ticks;
+}
+
+Value globalVariable(const std::string& name){
+    for(const auto& variable : globals.variables){
+        if(variable.name == name) return variable.value;
+    }
+    return Value();
+}
+
+void stop(){
+    cleanupSprites();
+}
+
+}
@@ -0,0 +1,96 @@
+#pragma once
+#include <string>
+#include <utility>
+#include <vector>
+#include <nlohmann/json.hpp>
+#include "../scratch/value.hpp"
+
+// builds project.json the way the scratch editor saves it, so the benchmarks and checks
+// can make the projects they run in code instead of shipping sb3 files
+
+// a block input as it's saved: a literal, or the id of the block in it
+struct BuiltInput {
+    nlohmann::json json;
+    std::string child; // the block in the input, its parent gets set to the block using it
+};
+
+struct BuiltVariable {
+    std::string name;
+    std::string id;
+};
+
+BuiltInput number(double value);
+BuiltInput text(const std::string& value);
+BuiltInput reporter(const std::string& blockId);
+BuiltInput condition(const std::string& blockId);
+BuiltInput substack(const std::string& blockId); // an empty id leaves the substack empty
+BuiltInput menu(const std::string& shadowId);
+BuiltInput variable(const BuiltVariable& variable);
+
+using BuiltInputs = std::vector<std::pair<std::string, BuiltInput>>;
+
+class TargetBuilder {
+public:
+    TargetBuilder(const std::string& name, bool isStage = false);
+
+    BuiltVariable addVariable(const std::string& name, const nlohmann::json& value = 0);
+    BuiltVariable addList(const std::string& name, const nlohmann::json& items = nlohmann::json::array());
+    // any block. returns its id
+    std::string block(const std::string& opcode, const BuiltInputs& inputs = {}, const nlohmann::json& fields = nlohmann::json::object(),
+                      const nlohmann::json& mutation = nullptr, bool shadow = false);
+    // links the blocks one after another and returns the first. a script's hat is top level
+    std::string stack(const std::vector<std::string>& blockIds);
+    std::string script(const std::vector<std::string>& blockIds);
+
+    std::string whenFlagClicked();
+    std::string setVariable(const BuiltVariable& variable, const BuiltInput& value);
+    std::string changeVariable(const BuiltVariable& variable, const BuiltInput& value);
+    std::string repeat(const BuiltInput& times, const std::string& body);
+    std::string forever(const std::string& body);
+    std::string ifThen(const std::string& condition, const std::string& body);
+    std::string equals(const BuiltInput& a, const BuiltInput& b);
+    std::string stopThisScript();
+    std::string createCloneOfMyself();
+    std::string whenStartAsClone();
+    std::string deleteThisClone();
+    std::string broadcast(const std::string& message);
+    std::string whenIReceive(const std::string& message);
+    // the definition hat of a custom block without arguments
+    std::string defineProcedure(const std::string& proccode, bool warp);
+    std::string callProcedure(const std::string& proccode, bool warp);
+
+    // project settings are read from a comment on the stage
+    void addComment(const std::string& text);
+
+    nlohmann::json toJson(int layerOrder) const;
+
+    double x = 0;
+    double y = 0;
+    double direction = 90;
+    double size = 100;
+    bool visible = true;
+
+private:
+    std::string name;
+    bool isStage;
+    nlohmann::json variables = nlohmann::json::object();
+    nlohmann::json lists = nlohmann::json::object();
+    nlohmann::json broadcasts = nlohmann::json::object();
+    nlohmann::json blocks = nlohmann::json::object();
+    nlohmann::json comments = nlohmann::json::object();
+};
+
+// the stage comes first, like the editor saves it
+nlohmann::json buildProject(const std::vector<const TargetBuilder*>& targets);
+
+// runs a project on the headless platform
+namespace Headless {
+    // loads the project and clicks the green flag
+    void start(const nlohmann::json& project);
+    // runs frames until no script is running or maxTicks have run. returns the ticks run.
+    // every tick is a frame of its own. blocksCounted adds up blocksRun, which startFrame clears
+    int run(int maxTicks, size_t* blocksCounted = nullptr);
+    Value globalVariable(const std::string& name);
+    // unloads the project
+    void stop();
+}
@@ -4,6 +4,7 @@
 #include "scratch/render.hpp"
 #include "scratch/input.hpp"
 #include "scratch/unzip.hpp"
+#include "scratch/framePacer.hpp"
 #ifdef __3DS__
 #include "3ds/audio.hpp"
 #else
@@ -27,9 +28,6 @@ int main(int argc, char **argv)
 {
 	initApp();
 	
-	// this is for the FPS
-	std::chrono::_V2::system_clock::time_point startTime = std::chrono::high_resolution_clock::now();
-	std::chrono::_V2::system_clock::time_point endTime = std::chrono::high_resolution_clock::now();
 	//this is for frametime check
 	std::chrono::_V2::system_clock::time_point frameStartTime = std::chrono::high_resolution_clock::now();
 	std::chrono::_V2::system_clock::time_point frameEndTime = std::chrono::high_resolution_clock::now();
@@ -72,34 +70,53 @@ int main(int argc, char **argv)
 		}
 	}
 
+	// --turbo on the command line turns turbo mode on even if the project doesn't ask for it
+	for(int i = 1; i < argc; i++){
+		if(std::string(argv[i]) == "--turbo") Scratch::turbo = true;
+	}
+
 	BlockExecutor::timer = std::chrono::high_resolution_clock::now();
 	bool flagClickedExecuted = false;
 
+	FramePacer pacer;
+	pacer.start(Scratch::FPS);
+
 	while (Render::appShouldRun())
 	{
-		
-		endTime = std::chrono::high_resolution_clock::now();
-		if(endTime - startTime >= std::chrono::milliseconds(1000 / Scratch::FPS)){
-			startTime = std::chrono::high_resolution_clock::now();
-			frameStartTime = std::chrono::high_resolution_clock::now();
-
-			Input::getInput();
-			BlockExecutor::runRepeatBlocks();
-			Audio::update();
-			Render::renderSprites();
-			
-			// Execute flag clicked blocks after first frame is rendered
-			if (!flagClickedExecuted) {
-				BlockExecutor::runAllBlocksByOpcode(Block::EVENT_WHENFLAGCLICKED);
-				flagClickedExecuted = true;
+		pacer.waitForNextFrame();
+		frameStartTime = std::chrono::high_resolution_clock::now();
+
+		Input::getInput();
+		BlockExecutor::startFrame();
+		BlockExecutor::runRepeatBlocks();
+		if(Scratch::turbo){
+			// keep ticking until most of the frame is used, like the reference VM's 75%.
+			// an idle project stops right away instead of spinning through the budget
+			auto tickBudget = std::chrono::microseconds(750000 / Scratch::FPS);
+			while(!toExit && !BlockExecutor::threads.empty() && std::chrono::high_resolution_clock::now() - frameStartTime < tickBudget){
+				size_t ranBefore = blocksRun;
+				BlockExecutor::runRepeatBlocks();
+				if(blocksRun == ranBefore) break;
 			}
-
-			frameEndTime = std::chrono::high_resolution_clock::now();
-			auto frameDuration = frameEndTime - frameStartTime;
-			//std::cout << "\x1b[17;1HFrame time: " << frameDuration.count() << " ms" << std::endl;
-			//std::cout << "\x1b[18;1HSprites: " << sprites.size() << std::endl;
-			
 		}
+		Audio::update();
+		// turbo frames that didn't change anything on screen skip the render
+		if(!Scratch::turbo || BlockExecutor::redrawRequested){
+			Render::renderSprites();
+			BlockExecutor::redrawRequested = false;
+		}
+		
+		// Execute flag clicked blocks after first frame is rendered
+		if (!flagClickedExecuted) {
+			BlockExecutor::runAllBlocksByOpcode(Block::EVENT_WHENFLAGCLICKED);
+			flagClickedExecuted = true;
+		}
+
+		frameEndTime = std::chrono::high_resolution_clock::now();
+		auto frameDuration = frameEndTime - frameStartTime;
+		//std::cout << "\x1b[17;1HFrame time: " << frameDuration.count() << " ms" << std::endl;
+		//std::cout << "\x1b[18;1HSprites: " << sprites.size() << std::endl;
+
 		if(toExit){
 			break;
 		}
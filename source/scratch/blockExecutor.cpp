@@ -10,314 +10,526 @@
 #include "blocks/sound.hpp"
 
 size_t blocksRun = 0;
+double warpTimeUsed = 0;
 std::chrono::_V2::system_clock::time_point BlockExecutor::timer;
+std::vector<std::unique_ptr<Thread>> BlockExecutor::threads;
+std::unordered_map<std::pair<Block*, Sprite*>, Thread*, ScriptKeyHash> BlockExecutor::threadsByScript;
+Thread* BlockExecutor::currentThread = nullptr;
+bool BlockExecutor::redrawRequested = true;
+
+// every opcode is listed exactly once, either as a statement, a reporter or
+// as having no handler at all (hats that only start scripts, menus that are
+// only read through their parent's inputs).
+#define STATEMENT_HANDLERS(X) \
+    /* motion */ \
+    X(MOTION_MOVE_STEPS, MotionBlocks::moveSteps) \
+    X(MOTION_GOTOXY, MotionBlocks::goToXY) \
+    X(MOTION_GOTO, MotionBlocks::goTo) \
+    X(MOTION_CHANGEXBY, MotionBlocks::changeXBy) \
+    X(MOTION_CHANGEYBY, MotionBlocks::changeYBy) \
+    X(MOTION_SETX, MotionBlocks::setX) \
+    X(MOTION_SETY, MotionBlocks::setY) \
+    X(MOTION_GLIDE_SECS_TO_XY, MotionBlocks::glideSecsToXY) \
+    X(MOTION_GLIDE_TO, MotionBlocks::glideTo) \
+    X(MOTION_TURNRIGHT, MotionBlocks::turnRight) \
+    X(MOTION_TURNLEFT, MotionBlocks::turnLeft) \
+    X(MOTION_POINTINDIRECTION, MotionBlocks::pointInDirection) \
+    X(MOTION_POINT_TOWARD, MotionBlocks::pointToward) \
+    X(MOTION_SET_ROTATION_STYLE, MotionBlocks::setRotationStyle) \
+    X(MOTION_IF_ON_EDGE_BOUNCE, MotionBlocks::ifOnEdgeBounce) \
+    /* looks */ \
+    X(LOOKS_SHOW, LooksBlocks::show) \
+    X(LOOKS_HIDE, LooksBlocks::hide) \
+    X(LOOKS_SWITCHCOSTUMETO, LooksBlocks::switchCostumeTo) \
+    X(LOOKS_NEXTCOSTUME, LooksBlocks::nextCostume) \
+    X(LOOKS_SWITCHBACKDROPTO, LooksBlocks::switchBackdropTo) \
+    X(LOOKS_NEXTBACKDROP, LooksBlocks::nextBackdrop) \
+    X(LOOKS_GO_FORWARD_BACKWARD_LAYERS, LooksBlocks::goForwardBackwardLayers) \
+    X(LOOKS_GO_TO_FRONT_BACK, LooksBlocks::goToFrontBack) \
+    X(LOOKS_SETSIZETO, LooksBlocks::setSizeTo) \
+    X(LOOKS_CHANGESIZEBY, LooksBlocks::changeSizeBy) \
+    X(LOOKS_SET_EFFECT_TO, LooksBlocks::setEffectTo) \
+    X(LOOKS_CHANGE_EFFECT_BY, LooksBlocks::changeEffectBy) \
+    X(LOOKS_CLEAR_GRAPHIC_EFFECTS, LooksBlocks::clearGraphicEffects) \
+    /* sound */ \
+    X(SOUND_PLAYUNTILDONE, SoundBlocks::playUntilDone) \
+    X(SOUND_PLAY, SoundBlocks::play) \
+    X(SOUND_STOPALLSOUNDS, SoundBlocks::stopAllSounds) \
+    X(SOUND_CHANGEEFFECTBY, SoundBlocks::changeEffectBy) \
+    X(SOUND_SETEFFECTTO, SoundBlocks::setEffectTo) \
+    X(SOUND_CLEAREFFECTS, SoundBlocks::clearEffects) \
+    X(SOUND_CHANGEVOLUMETOBY, SoundBlocks::changeVolumeBy) \
+    X(SOUND_SETVOLUMETO, SoundBlocks::setVolumeTo) \
+    /* events */ \
+    X(EVENT_WHENFLAGCLICKED, EventBlocks::flagClicked) \
+    X(EVENT_BROADCAST, EventBlocks::broadcast) \
+    X(EVENT_BROADCASTANDWAIT, EventBlocks::broadcastAndWait) \
+    X(EVENT_WHEN_KEY_PRESSED, EventBlocks::whenKeyPressed) \
+    /* control */ \
+    X(CONTROL_IF, ControlBlocks::If) \
+    X(CONTROL_IF_ELSE, ControlBlocks::ifElse) \
+    X(CONTROL_CREATE_CLONE_OF, ControlBlocks::createCloneOf) \
+    X(CONTROL_DELETE_THIS_CLONE, ControlBlocks::deleteThisClone) \
+    X(CONTROL_STOP, ControlBlocks::stop) \
+    X(CONTROL_START_AS_CLONE, ControlBlocks::startAsClone) \
+    X(CONTROL_WAIT, ControlBlocks::wait) \
+    X(CONTROL_WAIT_UNTIL, ControlBlocks::waitUntil) \
+    X(CONTROL_REPEAT, ControlBlocks::repeat) \
+    X(CONTROL_REPEAT_UNTIL, ControlBlocks::repeatUntil) \
+    X(CONTROL_FOREVER, ControlBlocks::forever) \
+    /* data */ \
+    X(DATA_SETVARIABLETO, DataBlocks::setVariable) \
+    X(DATA_CHANGEVARIABLEBY, DataBlocks::changeVariable) \
+    X(DATA_ADD_TO_LIST, DataBlocks::addToList) \
+    X(DATA_DELETE_OF_LIST, DataBlocks::deleteFromList) \
+    X(DATA_DELETE_ALL_OF_LIST, DataBlocks::deleteAllOfList) \
+    X(DATA_INSERT_AT_LIST, DataBlocks::insertAtList) \
+    X(DATA_REPLACE_ITEM_OF_LIST, DataBlocks::replaceItemOfList) \
+    /* sensing */ \
+    X(SENSING_RESETTIMER, SensingBlocks::resetTimer) \
+    X(SENSING_ASK_AND_WAIT, SensingBlocks::askAndWait) \
+    X(SENSING_SET_DRAG_MODE, SensingBlocks::setDragMode) \
+    /* procedures / arguments */ \
+    X(PROCEDURES_CALL, ProcedureBlocks::call) \
+    X(PROCEDURES_DEFINITION, ProcedureBlocks::definition) \
+
+#define VALUE_HANDLERS(X) \
+    /* motion */ \
+    X(MOTION_XPOSITION, MotionBlocks::xPosition) \
+    X(MOTION_YPOSITION, MotionBlocks::yPosition) \
+    X(MOTION_DIRECTION, MotionBlocks::direction) \
+    /* looks */ \
+    X(LOOKS_SIZE, LooksBlocks::size) \
+    X(LOOKS_COSTUME, LooksBlocks::costume) \
+    X(LOOKS_BACKDROPS, LooksBlocks::backdrops) \
+    X(LOOKS_COSTUMENUMBERNAME, LooksBlocks::costumeNumberName) \
+    X(LOOKS_BACKDROPNUMBERNAME, LooksBlocks::backdropNumberName) \
+    /* sound */ \
+    X(SOUND_VOLUME, SoundBlocks::volume) \
+    X(SOUND_SOUNDS_MENU, SoundBlocks::soundsMenu) \
+    /* operators */ \
+    X(OPERATOR_ADD, OperatorBlocks::add) \
+    X(OPERATOR_SUBTRACT, OperatorBlocks::subtract) \
+    X(OPERATOR_MULTIPLY, OperatorBlocks::multiply) \
+    X(OPERATOR_DIVIDE, OperatorBlocks::divide) \
+    X(OPERATOR_RANDOM, OperatorBlocks::random) \
+    X(OPERATOR_JOIN, OperatorBlocks::join) \
+    X(OPERATOR_LETTER_OF, OperatorBlocks::letterOf) \
+    X(OPERATOR_LENGTH, OperatorBlocks::length) \
+    X(OPERATOR_MOD, OperatorBlocks::mod) \
+    X(OPERATOR_ROUND, OperatorBlocks::round) \
+    X(OPERATOR_MATHOP, OperatorBlocks::mathOp) \
+    X(OPERATOR_EQUALS, OperatorBlocks::equals) \
+    X(OPERATOR_GT, OperatorBlocks::greaterThan) \
+    X(OPERATOR_LT, OperatorBlocks::lessThan) \
+    X(OPERATOR_AND, OperatorBlocks::and_) \
+    X(OPERATOR_OR, OperatorBlocks::or_) \
+    X(OPERATOR_NOT, OperatorBlocks::not_) \
+    X(OPERATOR_CONTAINS, OperatorBlocks::contains) \
+    /* data */ \
+    X(DATA_ITEMOFLIST, DataBlocks::itemOfList) \
+    X(DATA_ITEMNUMOFLIST, DataBlocks::itemNumOfList) \
+    X(DATA_LENGTHOFLIST, DataBlocks::lengthOfList) \
+    X(DATA_LIST_CONTAINS_ITEM, DataBlocks::listContainsItem) \
+    /* sensing */ \
+    X(SENSING_TIMER, SensingBlocks::sensingTimer) \
+    X(SENSING_OF, SensingBlocks::of) \
+    X(SENSING_MOUSEX, SensingBlocks::mouseX) \
+    X(SENSING_MOUSEY, SensingBlocks::mouseY) \
+    X(SENSING_DISTANCETO, SensingBlocks::distanceTo) \
+    X(SENSING_DAYS_SINCE_2000, SensingBlocks::daysSince2000) \
+    X(SENSING_CURRENT, SensingBlocks::current) \
+    X(SENSING_ANSWER, SensingBlocks::sensingAnswer) \
+    X(SENSING_KEYPRESSED, SensingBlocks::keyPressed) \
+    X(SENSING_TOUCHINGOBJECT, SensingBlocks::touchingObject) \
+    X(SENSING_MOUSEDOWN, SensingBlocks::mouseDown) \
+    X(SENSING_USERNAME, SensingBlocks::username) \
+    /* procedures / arguments */ \
+    X(ARGUMENT_REPORTER_STRING_NUMBER, ProcedureBlocks::stringNumber) \
+    X(ARGUMENT_REPORTER_BOOLEAN, ProcedureBlocks::booleanArgument) \
+
+#define NO_HANDLERS(X) \
+    X(NONE) \
+    X(EVENT_WHENBROADCASTRECEIVED) \
+    X(PROCEDURES_PROTOTYPE) \
+    X(MOTION_POINT_TOWARD_MENU) \
+    X(MOTION_GOTO_MENU) \
+    X(MOTION_GLIDE_TO_MENU) \
+    X(CONTROL_WHILE) \
+    X(CONTROL_CREATE_CLONE_OF_MENU) \
+    X(SENSING_KEYOPTIONS) \
+    X(SENSING_OF_OBJECT_MENU) \
+    X(SENSING_TOUCHINGOBJECTMENU) \
+    X(SENSING_DISTANCETO_MENU) \
+
+struct HandlerTable {
+    BlockHandler handlers[Block::OPCODE_COUNT] = {};
+    ValueHandler valueHandlers[Block::OPCODE_COUNT] = {};
+    int entries[Block::OPCODE_COUNT] = {};
+};
+
+static constexpr HandlerTable buildHandlerTable(){
+    HandlerTable table;
+#define X(opcode, handler) table.handlers[Block::opcode] = handler; table.entries[Block::opcode]++;
+    STATEMENT_HANDLERS(X)
+#undef X
+#define X(opcode, handler) table.valueHandlers[Block::opcode] = handler; table.entries[Block::opcode]++;
+    VALUE_HANDLERS(X)
+#undef X
+#define X(opcode) table.entries[Block::opcode]++;
+    NO_HANDLERS(X)
+#undef X
+    return table;
+}
+
+static constexpr bool coversEveryOpcode(const HandlerTable& table){
+    for(int entries : table.entries){
+        if(entries != 1) return false;
+    }
+    return true;
+}
 
-BlockExecutor::BlockExecutor(){
-    registerHandlers();
+// statements that change what's on screen. turbo mode only renders once one of these ran,
+// and the sprite that ran one is refiled in its grid before the next touching check
+static constexpr bool requestsRedraw(Block::opCode opcode){
+    switch(opcode){
+        case Block::MOTION_MOVE_STEPS:
+        case Block::MOTION_GOTOXY:
+        case Block::MOTION_GOTO:
+        case Block::MOTION_CHANGEXBY:
+        case Block::MOTION_CHANGEYBY:
+        case Block::MOTION_SETX:
+        case Block::MOTION_SETY:
+        case Block::MOTION_GLIDE_SECS_TO_XY:
+        case Block::MOTION_GLIDE_TO:
+        case Block::MOTION_TURNRIGHT:
+        case Block::MOTION_TURNLEFT:
+        case Block::MOTION_POINTINDIRECTION:
+        case Block::MOTION_POINT_TOWARD:
+        case Block::MOTION_SET_ROTATION_STYLE:
+        case Block::MOTION_IF_ON_EDGE_BOUNCE:
+        case Block::LOOKS_SHOW:
+        case Block::LOOKS_HIDE:
+        case Block::LOOKS_SWITCHCOSTUMETO:
+        case Block::LOOKS_NEXTCOSTUME:
+        case Block::LOOKS_SWITCHBACKDROPTO:
+        case Block::LOOKS_NEXTBACKDROP:
+        case Block::LOOKS_GO_FORWARD_BACKWARD_LAYERS:
+        case Block::LOOKS_GO_TO_FRONT_BACK:
+        case Block::LOOKS_SETSIZETO:
+        case Block::LOOKS_CHANGESIZEBY:
+        case Block::LOOKS_SET_EFFECT_TO:
+        case Block::LOOKS_CHANGE_EFFECT_BY:
+        case Block::LOOKS_CLEAR_GRAPHIC_EFFECTS:
+        case Block::CONTROL_CREATE_CLONE_OF:
+        case Block::CONTROL_DELETE_THIS_CLONE:
+        case Block::SENSING_ASK_AND_WAIT:
+            return true;
+        default:
+            return false;
+    }
 }
 
-void BlockExecutor::registerHandlers(){
-
-    // motion
-    handlers[Block::MOTION_MOVE_STEPS] = MotionBlocks::moveSteps;
-    handlers[Block::MOTION_GOTOXY] = MotionBlocks::goToXY;
-    handlers[Block::MOTION_GOTO] = MotionBlocks::goTo;
-    handlers[Block::MOTION_CHANGEXBY] = MotionBlocks::changeXBy;
-    handlers[Block::MOTION_CHANGEYBY] = MotionBlocks::changeYBy;
-    handlers[Block::MOTION_SETX] = MotionBlocks::setX;
-    handlers[Block::MOTION_SETY] = MotionBlocks::setY;
-    handlers[Block::MOTION_GLIDE_SECS_TO_XY] = MotionBlocks::glideSecsToXY;
-    handlers[Block::MOTION_GLIDE_TO] = MotionBlocks::glideTo;
-    handlers[Block::MOTION_TURNRIGHT] = MotionBlocks::turnRight;
-    handlers[Block::MOTION_TURNLEFT] = MotionBlocks::turnLeft;
-    handlers[Block::MOTION_POINTINDIRECTION] = MotionBlocks::pointInDirection;
-    handlers[Block::MOTION_POINT_TOWARD] = MotionBlocks::pointToward;
-    handlers[Block::MOTION_SET_ROTATION_STYLE] = MotionBlocks::setRotationStyle;
-    handlers[Block::MOTION_IF_ON_EDGE_BOUNCE] = MotionBlocks::ifOnEdgeBounce;
-    valueHandlers[Block::MOTION_XPOSITION] = MotionBlocks::xPosition;
-    valueHandlers[Block::MOTION_YPOSITION] = MotionBlocks::yPosition;
-    valueHandlers[Block::MOTION_DIRECTION] = MotionBlocks::direction;
-    
-    // looks
-    handlers[Block::LOOKS_SHOW] = LooksBlocks::show;
-    handlers[Block::LOOKS_HIDE] = LooksBlocks::hide;
-    handlers[Block::LOOKS_SWITCHCOSTUMETO] = LooksBlocks::switchCostumeTo;
-    handlers[Block::LOOKS_NEXTCOSTUME] = LooksBlocks::nextCostume;
-    handlers[Block::LOOKS_SWITCHBACKDROPTO] = LooksBlocks::switchBackdropTo;
-    handlers[Block::LOOKS_NEXTBACKDROP] = LooksBlocks::nextBackdrop;
-    handlers[Block::LOOKS_GO_FORWARD_BACKWARD_LAYERS] = LooksBlocks::goForwardBackwardLayers;
-    handlers[Block::LOOKS_GO_TO_FRONT_BACK] = LooksBlocks::goToFrontBack;
-    handlers[Block::LOOKS_SETSIZETO] = LooksBlocks::setSizeTo;
-    handlers[Block::LOOKS_CHANGESIZEBY] = LooksBlocks::changeSizeBy;
-    handlers[Block::LOOKS_SET_EFFECT_TO] = LooksBlocks::setEffectTo;
-    handlers[Block::LOOKS_CHANGE_EFFECT_BY] = LooksBlocks::changeEffectBy;
-    handlers[Block::LOOKS_CLEAR_GRAPHIC_EFFECTS] = LooksBlocks::clearGraphicEffects;
-    valueHandlers[Block::LOOKS_SIZE] = LooksBlocks::size;
-    valueHandlers[Block::LOOKS_COSTUME] = LooksBlocks::costume;
-    valueHandlers[Block::LOOKS_BACKDROPS] = LooksBlocks::backdrops;
-    valueHandlers[Block::LOOKS_COSTUMENUMBERNAME] = LooksBlocks::costumeNumberName;
-    valueHandlers[Block::LOOKS_BACKDROPNUMBERNAME] = LooksBlocks::backdropNumberName;
-    
-    // sound
-    valueHandlers[Block::SOUND_VOLUME] = SoundBlocks::volume;
-    valueHandlers[Block::SOUND_SOUNDS_MENU] = SoundBlocks::soundsMenu;
-    handlers[Block::SOUND_PLAYUNTILDONE] = SoundBlocks::playUntilDone;
-    handlers[Block::SOUND_PLAY] = SoundBlocks::play;
-    handlers[Block::SOUND_STOPALLSOUNDS] = SoundBlocks::stopAllSounds;
-    handlers[Block::SOUND_CHANGEEFFECTBY] = SoundBlocks::changeEffectBy;
-    handlers[Block::SOUND_SETEFFECTTO] = SoundBlocks::setEffectTo;
-    handlers[Block::SOUND_CLEAREFFECTS] = SoundBlocks::clearEffects;
-    handlers[Block::SOUND_CHANGEVOLUMETOBY] = SoundBlocks::changeVolumeBy;
-    handlers[Block::SOUND_SETVOLUMETO] = SoundBlocks::setVolumeTo;
-
-    // events
-    handlers[Block::EVENT_WHENFLAGCLICKED] = EventBlocks::flagClicked;
-    handlers[Block::EVENT_BROADCAST] = EventBlocks::broadcast;
-    handlers[Block::EVENT_BROADCASTANDWAIT] = EventBlocks::broadcastAndWait;
-    handlers[Block::EVENT_WHEN_KEY_PRESSED] = EventBlocks::whenKeyPressed;
-
-
-    // control
-    handlers[Block::CONTROL_IF] = ControlBlocks::If;
-    handlers[Block::CONTROL_IF_ELSE] = ControlBlocks::ifElse;
-    handlers[Block::CONTROL_CREATE_CLONE_OF] = ControlBlocks::createCloneOf;
-    handlers[Block::CONTROL_DELETE_THIS_CLONE] = ControlBlocks::deleteThisClone;
-    handlers[Block::CONTROL_STOP] = ControlBlocks::stop;
-    handlers[Block::CONTROL_START_AS_CLONE] = ControlBlocks::startAsClone;
-    handlers[Block::CONTROL_WAIT] = ControlBlocks::wait;
-    handlers[Block::CONTROL_WAIT_UNTIL] = ControlBlocks::waitUntil;
-    handlers[Block::CONTROL_REPEAT] = ControlBlocks::repeat;
-    handlers[Block::CONTROL_REPEAT_UNTIL] = ControlBlocks::repeatUntil;
-    handlers[Block::CONTROL_FOREVER] = ControlBlocks::forever;
-
-    // operators
-    valueHandlers[Block::OPERATOR_ADD] = OperatorBlocks::add;
-    valueHandlers[Block::OPERATOR_SUBTRACT] = OperatorBlocks::subtract;
-    valueHandlers[Block::OPERATOR_MULTIPLY] = OperatorBlocks::multiply;
-    valueHandlers[Block::OPERATOR_DIVIDE] = OperatorBlocks::divide;
-    valueHandlers[Block::OPERATOR_RANDOM] = OperatorBlocks::random;
-    valueHandlers[Block::OPERATOR_JOIN] = OperatorBlocks::join;
-    valueHandlers[Block::OPERATOR_LETTER_OF] = OperatorBlocks::letterOf;
-    valueHandlers[Block::OPERATOR_LENGTH] = OperatorBlocks::length;
-    valueHandlers[Block::OPERATOR_MOD] = OperatorBlocks::mod;
-    valueHandlers[Block::OPERATOR_ROUND] = OperatorBlocks::round;
-    valueHandlers[Block::OPERATOR_MATHOP] = OperatorBlocks::mathOp;
-    valueHandlers[Block::OPERATOR_EQUALS] = OperatorBlocks::equals;
-    valueHandlers[Block::OPERATOR_GT] = OperatorBlocks::greaterThan;
-    valueHandlers[Block::OPERATOR_LT] = OperatorBlocks::lessThan;
-    valueHandlers[Block::OPERATOR_AND] = OperatorBlocks::and_;
-    valueHandlers[Block::OPERATOR_OR] = OperatorBlocks::or_;
-    valueHandlers[Block::OPERATOR_NOT] = OperatorBlocks::not_;
-    valueHandlers[Block::OPERATOR_CONTAINS] = OperatorBlocks::contains;
-
-    // data
-    handlers[Block::DATA_SETVARIABLETO] = DataBlocks::setVariable;
-    handlers[Block::DATA_CHANGEVARIABLEBY] = DataBlocks::changeVariable;
-    handlers[Block::DATA_ADD_TO_LIST] = DataBlocks::addToList;
-    handlers[Block::DATA_DELETE_OF_LIST] = DataBlocks::deleteFromList;
-    handlers[Block::DATA_DELETE_ALL_OF_LIST] = DataBlocks::deleteAllOfList;
-    handlers[Block::DATA_INSERT_AT_LIST] = DataBlocks::insertAtList;
-    handlers[Block::DATA_REPLACE_ITEM_OF_LIST] = DataBlocks::replaceItemOfList;
-    valueHandlers[Block::DATA_ITEMOFLIST] = DataBlocks::itemOfList;
-    valueHandlers[Block::DATA_ITEMNUMOFLIST] = DataBlocks::itemNumOfList;
-    valueHandlers[Block::DATA_LENGTHOFLIST] = DataBlocks::lengthOfList;
-    valueHandlers[Block::DATA_LIST_CONTAINS_ITEM] = DataBlocks::listContainsItem;
-
-
-    // sensing
-    handlers[Block::SENSING_RESETTIMER] = SensingBlocks::resetTimer;
-    handlers[Block::SENSING_ASK_AND_WAIT] = SensingBlocks::askAndWait;
-    handlers[Block::SENSING_SET_DRAG_MODE] = SensingBlocks::setDragMode;
-    valueHandlers[Block::SENSING_TIMER] = SensingBlocks::sensingTimer;
-    valueHandlers[Block::SENSING_OF] = SensingBlocks::of;
-    valueHandlers[Block::SENSING_MOUSEX] = SensingBlocks::mouseX;
-    valueHandlers[Block::SENSING_MOUSEY] = SensingBlocks::mouseY;
-    valueHandlers[Block::SENSING_DISTANCETO] = SensingBlocks::distanceTo;
-    valueHandlers[Block::SENSING_DAYS_SINCE_2000] = SensingBlocks::daysSince2000;
-    valueHandlers[Block::SENSING_CURRENT] = SensingBlocks::current;
-    valueHandlers[Block::SENSING_ANSWER] = SensingBlocks::sensingAnswer;
-    valueHandlers[Block::SENSING_KEYPRESSED] = SensingBlocks::keyPressed;
-    valueHandlers[Block::SENSING_TOUCHINGOBJECT] = SensingBlocks::touchingObject;
-    valueHandlers[Block::SENSING_MOUSEDOWN] = SensingBlocks::mouseDown;
-    valueHandlers[Block::SENSING_USERNAME] = SensingBlocks::username;
-
-    // procedures / arguments
-    handlers[Block::PROCEDURES_CALL] = ProcedureBlocks::call;
-    handlers[Block::PROCEDURES_DEFINITION] = ProcedureBlocks::definition;
-    valueHandlers[Block::ARGUMENT_REPORTER_STRING_NUMBER] = ProcedureBlocks::stringNumber;
-    valueHandlers[Block::ARGUMENT_REPORTER_BOOLEAN] = ProcedureBlocks::booleanArgument;
+static constexpr HandlerTable handlerTable = buildHandlerTable();
+static_assert(coversEveryOpcode(handlerTable), "every Block::opCode needs exactly one entry in STATEMENT_HANDLERS, VALUE_HANDLERS or NO_HANDLERS");
+
+// moves a frame on to the next block, forgetting what the last one was waiting on
+static inline void advance(Frame& frame, int next){
+    frame.pc = next;
+    if (frame.state.started) frame.state = BlockState();
+}
 
+void BlockExecutor::startWarpTimer(Thread& thread){
+    if (thread.warpTimerRunning) return;
+    thread.warpTimerRunning = true;
+    thread.warpStart = std::chrono::high_resolution_clock::now();
 }
 
-void BlockExecutor::runBlock(Block& block, Sprite* sprite, Block* waitingBlock, bool* withoutScreenRefresh){
-    auto start = std::chrono::high_resolution_clock::now();
-    Block* currentBlock = &block;
+// warp frames run loops and waits without yielding, but only until the thread used up
+// its warp budget for this frame. then it suspends like any other thread and carries on next frame
+static bool keepWarping(const Frame& frame, const Thread& thread){
+    if (!frame.warp) return false;
+    auto elapsed = std::chrono::high_resolution_clock::now() - thread.warpStart;
+    return elapsed < std::chrono::milliseconds(Scratch::warpTimeBudget);
+}
 
-    bool localWithoutRefresh = false;
-    if (!withoutScreenRefresh) {
-        withoutScreenRefresh = &localWithoutRefresh;
+static void stopWarpTimer(Thread& thread){
+    if (!thread.warpTimerRunning) return;
+    thread.warpTimerRunning = false;
+    std::chrono::duration<double, std::milli> elapsed = std::chrono::high_resolution_clock::now() - thread.warpStart;
+    warpTimeUsed += elapsed.count();
+}
+
+// the top frame ran off its end. loops go back to the block that started them, anything
+// else carries on after it. returns false when the thread is done or yields
+static bool endFrame(Thread& thread){
+    bool isLoop = thread.frames.back().isLoop;
+    thread.frames.pop_back();
+    if (thread.isDone()) return false;
+
+    Frame& frame = thread.frames.back();
+    if (isLoop) return keepWarping(frame, thread);
+    advance(frame, thread.sprite->shared->program[frame.pc].next);
+    return true;
+}
+
+// anything but CONTINUE. returns false when the thread stops running for this frame
+static bool settle(Thread& thread, BlockResult result){
+    switch (result) {
+        case BlockResult::RETURN:
+            return keepWarping(thread.frames.back(), thread);
+        case BlockResult::BREAK:
+            thread.stop();
+            return false;
+        default:
+            return true;
     }
-    
+}
+
+// runs a thread until it yields or finishes
+void BlockExecutor::runThread(Thread& thread){
+    Sprite* sprite = thread.sprite;
     if (!sprite || sprite->toDelete) {
+        thread.stop();
         return;
     }
+    if (thread.isDone()) return;
+
+    Thread* previousThread = currentThread;
+    currentThread = &thread;
+    if (thread.frames.back().warp) startWarpTimer(thread);
+    const std::vector<Instruction>& program = sprite->shared->program;
+
+#ifdef SCRATCH_COMPUTED_GOTO
+    // one label per statement opcode, each calling its handler directly and
+    // ending in its own indirect jump to the next instruction.
+    static void* dispatch[Block::OPCODE_COUNT];
+    static bool dispatchReady = false;
+    if (!dispatchReady) {
+        for (void*& label : dispatch) label = &&no_handler;
+#define X(opcode, handler) dispatch[Block::opcode] = &&run_##opcode;
+        STATEMENT_HANDLERS(X)
+#undef X
+        dispatchReady = true;
+    }
 
-    while (currentBlock && currentBlock->id != "null") {
+    const Instruction* instruction;
+    BlockResult result;
+
+#define DISPATCH_NEXT() \
+    if (thread.frames.back().pc == -1) goto frame_ended; \
+    instruction = &program[thread.frames.back().pc]; \
+    blocksRun += 1; \
+    goto *dispatch[instruction->opcode];
+
+#define ADVANCE() \
+    advance(thread.frames.back(), instruction->next); \
+    DISPATCH_NEXT()
+
+    DISPATCH_NEXT()
+
+#define X(opcode, handler) \
+    run_##opcode: \
+    if constexpr (requestsRedraw(Block::opcode)) { redrawRequested = true; markMoved(sprite); } \
+    result = handler(*instruction->block, sprite, &thread); \
+    if (result != BlockResult::CONTINUE) goto settle_result; \
+    ADVANCE()
+    STATEMENT_HANDLERS(X)
+#undef X
+
+no_handler:
+    ADVANCE()
+
+settle_result:
+    if (!settle(thread, result)) goto finished;
+    DISPATCH_NEXT()
+
+frame_ended:
+    if (!endFrame(thread)) goto finished;
+    DISPATCH_NEXT()
+
+#undef ADVANCE
+#undef DISPATCH_NEXT
+finished:
+#else
+    while (true) {
+        Frame& frame = thread.frames.back();
+        if (frame.pc == -1) {
+            if (!endFrame(thread)) break;
+            continue;
+        }
         blocksRun += 1;
 
-        BlockResult result = executeBlock(*currentBlock, sprite, &waitingBlock, withoutScreenRefresh);
-        
-        if (result == BlockResult::RETURN) {
-            return;
-        } else if (result == BlockResult::BREAK) {
-            break;
-        }
+        const Instruction& instruction = program[frame.pc];
+        BlockResult result = executeBlock(*instruction.block, sprite, &thread);
 
-        // Move to next block
-        if (!currentBlock->next.empty()) {
-            currentBlock = &sprite->blocks[currentBlock->next];
-            
-        } else {
-            runBroadcasts();
-                break;
+        if (result == BlockResult::CONTINUE) {
+            advance(thread.frames.back(), instruction.next);
+        } else if (!settle(thread, result)) {
+            break;
         }
     }
+#endif
 
-
-        // Timing measurement
-    auto end = std::chrono::high_resolution_clock::now();
-    std::chrono::duration<double, std::milli> duration = end - start;
-    if (duration.count() > 0) {
-        //std::cout << " took " << duration.count() << " milliseconds!" << std::endl;
+    stopWarpTimer(thread);
+    if (thread.restartPending) {
+        thread.restartPending = false;
+        thread.restart();
     }
+    currentThread = previousThread;
 }
 
 
-BlockResult BlockExecutor::executeBlock(Block& block, Sprite* sprite,Block** waitingBlock, bool* withoutScreenRefresh){
-    auto iterator = handlers.find(block.opcode);
-    if (iterator != handlers.end()) {
-        return iterator->second(block, sprite, waitingBlock, withoutScreenRefresh);
+BlockResult BlockExecutor::executeBlock(Block& block, Sprite* sprite, Thread* thread){
+    BlockHandler handler = handlerTable.handlers[block.opcode];
+    if (requestsRedraw(block.opcode)) {
+        redrawRequested = true;
+        markMoved(sprite);
+    }
+    if (handler) {
+        return handler(block, sprite, thread);
     }
 
     return BlockResult::CONTINUE;
 }
 
-void BlockExecutor::runRepeatBlocks(){
-    blocksRun = 0;
+// the script's thread in the sprite, if it's still running
+static Thread* runningThread(Block* topBlock, Sprite* sprite){
+    auto found = BlockExecutor::threadsByScript.find({topBlock, sprite});
+    if (found == BlockExecutor::threadsByScript.end()) return nullptr;
+    Thread* thread = found->second;
+    if (thread->isDone() || thread->isStale()) return nullptr;
+    return thread;
+}
 
-    // repeat ONLY the block most recently added to the repeat chain,,,
-    for(auto& sprite : sprites){
-        for(auto& [id, blockChain]: sprite->blockChains){
-        auto& repeatList = blockChain.blocksToRepeat;
-            if (!repeatList.empty()) {
-                std::string toRepeat = repeatList.back();
-                if(!toRepeat.empty()){
-                Block* toRun = &sprite->blocks[toRepeat];
-                if(toRun != nullptr){
-                executor.runBlock(*toRun, sprite);
-                }
-                }
-            } 
-        }
-    }
-    // delete sprites ready for deletion
-
-    for(auto& toDelete : sprites){
-        if(!toDelete->toDelete) continue;
-        for(auto& [id,block] : toDelete->blocks){
-        for (std::string repeatID : toDelete->blockChains[block.blockChainID].blocksToRepeat) {
-            Block* repeatBlock = findBlock(repeatID);
-            if (repeatBlock) {
-                repeatBlock->repeatTimes = -1;
-            }
-        }
-    }
-    toDelete->isDeleted = true;
+Thread* BlockExecutor::startThread(Block* topBlock, Sprite* sprite, bool restartExisting){
+    if (Thread* thread = runningThread(topBlock, sprite)) {
+        // a script that is already running starts over instead of running twice.
+        // the running thread can't drop its frames from under its own block, it restarts once it stops
+        if (restartExisting && thread == currentThread) thread->restartPending = true;
+        else if (restartExisting) thread->restart();
+        return thread;
     }
-    //std::cout << "\x1b[19;1HBlocks Running: " << blocksRun << std::endl;
-    sprites.erase(std::remove_if(sprites.begin(), sprites.end(), [](Sprite* s) { return s->toDelete; }), sprites.end());
 
+    threads.push_back(std::make_unique<Thread>());
+    Thread* thread = threads.back().get();
+    thread->sprite = sprite;
+    thread->generation = sprite->generation;
+    thread->topBlock = topBlock;
+    thread->restart();
+    threadsByScript[{topBlock, sprite}] = thread;
+    return thread;
 }
 
-void BlockExecutor::runRepeatsWithoutRefresh(Sprite* sprite,std::string blockChainID){
-    if(sprite->blockChains.find(blockChainID) != sprite->blockChains.end()){
-        while(!sprite->blockChains[blockChainID].blocksToRepeat.empty()){
-            std::string toRepeat = sprite->blockChains[blockChainID].blocksToRepeat.back();
-            Block* toRun = findBlock(toRepeat);
-            if(toRun != nullptr)
-            executor.runBlock(*toRun, sprite);
-                
-        }
-    }    
+bool BlockExecutor::isRunning(Block* topBlock, Sprite* sprite){
+    return runningThread(topBlock, sprite) != nullptr;
 }
 
-std::vector<std::pair<Block*, Sprite*>> BlockExecutor::runBroadcasts() {
+void BlockExecutor::clearThreads(){
+    threads.clear();
+    threadsByScript.clear();
+}
 
-std::vector<std::pair<Block*, Sprite*>> blocksToRun;
+void BlockExecutor::stopOtherThreads(Sprite* sprite, Thread* except){
+    for (auto& thread : threads) {
+        if (thread->sprite == sprite && thread.get() != except) thread->stop();
+    }
+}
+
+void BlockExecutor::startFrame(){
+    blocksRun = 0;
+    warpTimeUsed = 0;
+}
 
-    if (broadcastQueue.empty()) {
-        return blocksToRun;
+void BlockExecutor::runRepeatBlocks(){
+    // rendering can change a sprite's size without running a block
+    markResizedSprites();
+
+    // every thread gets one turn, in the order they were started. threads started
+    // during the frame (broadcasts, clones) are at the back and still get theirs.
+    // broadcasts are started after the turn of the thread that sent them
+    runBroadcasts();
+    for (size_t i = 0; i < threads.size(); i++) {
+        executor.runThread(*threads[i]);
+        if (!broadcastQueue.empty()) runBroadcasts();
     }
-    
-    std::string currentBroadcast = broadcastQueue.front();
-    broadcastQueue.erase(broadcastQueue.begin());
-    
-
-    for (auto* currentSprite : sprites) {
-        for (auto& [id, block] : currentSprite->blocks) {
-            if (block.opcode == block.EVENT_WHENBROADCASTRECEIVED && 
-                block.fields["BROADCAST_OPTION"][0] == currentBroadcast) {
-                blocksToRun.push_back({&block, currentSprite});
-            }
+
+    // give the slots of clones deleted this tick back to the pool. their threads are stale after that
+    if (!clonePool.deleted.empty()) {
+        for (Sprite* clone : clonePool.deleted) {
+            unregisterHats(clone);
+            unregisterSprite(clone);
+            clonePool.release(clone);
         }
+        clonePool.deleted.clear();
+        sprites.erase(std::remove_if(sprites.begin(), sprites.end(), [](Sprite* s) { return s->toDelete; }), sprites.end());
     }
+    auto finished = [](const std::unique_ptr<Thread>& t) { return t->isDone() || t->isStale(); };
+    for (const auto& thread : threads) {
+        if (!finished(thread)) continue;
+        auto indexed = threadsByScript.find({thread->topBlock, thread->sprite});
+        if (indexed != threadsByScript.end() && indexed->second == thread.get()) threadsByScript.erase(indexed);
+    }
+    threads.erase(std::remove_if(threads.begin(), threads.end(), finished), threads.end());
+    //std::cout << "\x1b[19;1HBlocks Running: " << blocksRun << std::endl;
+
+}
 
-    for (auto& [blockPtr, spritePtr] : blocksToRun) {
-        //std::cout << "Running broadcast block " << blockPtr->id << std::endl;
-        executor.runBlock(*blockPtr, spritePtr);
+// starts the receivers of every waiting broadcast. they're added to the back of the run
+// queue, so they get their turn later in the same tick
+void BlockExecutor::runBroadcasts() {
+    int message;
+    while ((message = broadcastQueue.pop()) != -1) {
+        startBroadcast(message);
     }
+}
 
-    if (!broadcastQueue.empty()) {
-        runBroadcasts();
+const std::vector<std::pair<Block*, Sprite*>>& BlockExecutor::startBroadcast(int message) {
+    broadcastQueue.cancel(message);
+    const std::vector<std::pair<Block*, Sprite*>>& receivers = globals.receivers[message];
+    for (auto& [hat, sprite] : receivers) {
+        //std::cout << "Running broadcast block " << hat->id << std::endl;
+        startThread(hat, sprite);
     }
-    return blocksToRun;
+    return receivers;
 }
 
 std::vector<Block*> BlockExecutor::runAllBlocksByOpcode(Block::opCode opcodeToFind){
     //std::cout << "Running all " << opcodeToFind << " blocks." << "\n";
     std::vector<Block*> blocksRun;
+    if(opcodeToFind == Block::EVENT_WHENFLAGCLICKED){
+        for(auto& [hat, sprite] : globals.flagHats){
+            blocksRun.push_back(hat);
+            startThread(hat, sprite);
+        }
+        return blocksRun;
+    }
+
     for(Sprite *currentSprite : sprites){
-        for(auto &[id,data] : currentSprite->blocks){
+        for(auto &[id,data] : currentSprite->shared->blocks){
             if(data.opcode == opcodeToFind){
-                //runBlock(data,currentSprite);
                 blocksRun.push_back(&data);
-                executor.runBlock(data,currentSprite);
+                startThread(&data, currentSprite);
             }
         }
     }
     return blocksRun;
 }
 
-Value BlockExecutor::getBlockValue(Block& block,Sprite*sprite){
-    auto iterator = valueHandlers.find(block.opcode);
-    if (iterator != valueHandlers.end()) {
-        return iterator->second(block, sprite);
+void BlockExecutor::runKeyPressedHats(const Input::KeySet& keys){
+    if(keys.none()) return;
+    for(int key = 0; key < Input::keyCount; key++){
+        if(!keys[key]) continue;
+        // a held key keeps firing, so its scripts carry on instead of starting over
+        for(auto& [hat, sprite] : globals.keyHats[key]) startThread(hat, sprite, false);
     }
-
-    return Value(0);
 }
 
+Value BlockExecutor::getBlockValue(Block& block,Sprite*sprite){
+    ValueHandler handler = handlerTable.valueHandlers[block.opcode];
+    if (handler) {
+        return handler(block, sprite);
+    }
 
-void BlockExecutor::addToRepeatQueue(Sprite* sprite,Block* block){
-            auto& repeatList = sprite->blockChains[block->blockChainID].blocksToRepeat;
-            if (std::find(repeatList.begin(), repeatList.end(), block->id) == repeatList.end()) {
-                repeatList.push_back(block->id);
-            }
+    return Value(0);
 }
-
-bool BlockExecutor::hasActiveRepeats(Sprite* sprite,std::string blockChainID){
-    if(sprite->blockChains.find(blockChainID) != sprite->blockChains.end()){
-        if(!sprite->blockChains[blockChainID].blocksToRepeat.empty()) return true;
-    }
-    return false;
-}
\ No newline at end of file
@@ -1,39 +1,64 @@
 #pragma once
 #include <chrono>
 #include <unordered_map>
-#include <functional>
+#include <memory>
 #include "sprite.hpp"
 #include "interpret.hpp"
 
-extern size_t blocksRun;
+extern size_t blocksRun; // blocks run this frame
+extern double warpTimeUsed; // milliseconds spent in warp frames this frame
 
 enum class BlockResult {
-    CONTINUE,
-    RETURN,
-    BREAK
+    CONTINUE, // move on to the next block
+    RETURN,   // yield, the block runs again on the thread's next turn
+    BREAK,    // stop the script
+    BRANCH    // the block pushed a frame (substack or custom block), run that first
+};
+
+typedef BlockResult (*BlockHandler)(Block&, Sprite*, Thread*);
+typedef Value (*ValueHandler)(Block&, Sprite*);
+
+// the computed goto dispatch loop is on by default with GCC, build with
+// -DSCRATCH_NO_COMPUTED_GOTO to fall back to the plain table lookup.
+#if defined(__GNUC__) && !defined(__clang__) && !defined(SCRATCH_NO_COMPUTED_GOTO)
+#define SCRATCH_COMPUTED_GOTO
+#endif
+
+// hashes a (script, sprite) pair, what threads are looked up by
+struct ScriptKeyHash {
+    size_t operator()(const std::pair<Block*, Sprite*>& key) const {
+        return std::hash<Block*>()(key.first) ^ (std::hash<Sprite*>()(key.second) << 1);
+    }
 };
 
 class BlockExecutor {
-private:
-    std::unordered_map<Block::opCode, std::function<BlockResult(Block&, Sprite*,Block**, bool*)>> handlers;
-    std::unordered_map<Block::opCode, std::function<Value(Block&, Sprite*)>> valueHandlers;
-    //std::unordered_map<Block::opCode, std::function<Value(Block&,Sprite*)>> conditionBlockHandlers;
-    
 public:
-    BlockExecutor();
-    void runBlock(Block& block, Sprite* sprite, Block* waitingBlock = nullptr, bool* withoutScreenRefresh = nullptr);
+    void runThread(Thread& thread);
+    static Thread* startThread(Block* topBlock, Sprite* sprite, bool restartExisting = true);
+    static bool isRunning(Block* topBlock, Sprite* sprite);
+    static void stopOtherThreads(Sprite* sprite, Thread* except);
+    static void clearThreads();
+    static void startWarpTimer(Thread& thread);
     static std::vector<Block*> runAllBlocksByOpcode(Block::opCode opcodeToFind);
+    static void runKeyPressedHats(const Input::KeySet& keys);
     static void runRepeatBlocks();
-    static void runRepeatsWithoutRefresh(Sprite* sprite,std::string blockChainID);
-    static std::vector<std::pair<Block*, Sprite*>> runBroadcasts();
+    // clears blocksRun and warpTimeUsed. they add up over every tick run until the next call,
+    // so turbo frames report the whole frame
+    static void startFrame();
+    static void runBroadcasts();
+    static const std::vector<std::pair<Block*, Sprite*>>& startBroadcast(int message);
     Value getBlockValue(Block& block,Sprite*sprite);
     Value runConditionalBlock(std::string blockId, Sprite* sprite);
-    static void addToRepeatQueue(Sprite* sprite,Block* block);
-    static bool hasActiveRepeats(Sprite* sprite,std::string blockChainID);
 
     static std::chrono::_V2::system_clock::time_point timer;
+    static bool redrawRequested; // a block changed something on screen since the last render
+
+    // every running script, in the order they take their turns. new threads go to the back
+    static std::vector<std::unique_ptr<Thread>> threads;
+    // the newest thread of each script in each sprite, so starting a script again finds it without a scan
+    static std::unordered_map<std::pair<Block*, Sprite*>, Thread*, ScriptKeyHash> threadsByScript;
+    static Thread* currentThread; // the thread being run, for the argument reporters
     
 private:
-    void registerHandlers();
-    BlockResult executeBlock(Block& block, Sprite* sprite,Block** waitingBlock, bool* withoutScreenRefresh);
+    BlockResult executeBlock(Block& block, Sprite* sprite, Thread* thread);
 };
\ No newline at end of file
@@ -1,187 +1,112 @@
 #include "control.hpp"
 
-BlockResult ControlBlocks::If(Block& block, Sprite* sprite, Block** waitingBlock, bool* withoutScreenRefresh){
-    Value conditionValue = Scratch::getInputValue(block,"CONDITION",sprite);
+BlockResult ControlBlocks::If(Block& block, Sprite* sprite, Thread* thread){
+    Value conditionValue = Scratch::getInputValue(block, Block::CONDITION, sprite);
     bool condition = false;
     if(conditionValue.isNumeric()){
         condition = conditionValue.asDouble() != 0.0;
     } else condition = !conditionValue.asString().empty();
 
     if(condition){
-        auto it = block.parsedInputs.find("SUBSTACK");
-        if(it != block.parsedInputs.end()){
-            Block* subBlock = &sprite->blocks[it->second.blockId];
-            if(subBlock){
-                executor.runBlock(*subBlock,sprite);
-            }
-        }
+        thread->startBranch(sprite->shared->program[block.pc].substack, false);
+        return BlockResult::BRANCH;
     }
     return BlockResult::CONTINUE;
 }
 
-BlockResult ControlBlocks::ifElse(Block& block, Sprite* sprite, Block** waitingBlock, bool* withoutScreenRefresh){
-    Value conditionValue = Scratch::getInputValue(block,"CONDITION",sprite);
+BlockResult ControlBlocks::ifElse(Block& block, Sprite* sprite, Thread* thread){
+    Value conditionValue = Scratch::getInputValue(block, Block::CONDITION, sprite);
     bool condition = false;
     if(conditionValue.isNumeric()){
         condition = conditionValue.asDouble() != 0.0;
     } else condition = !conditionValue.asString().empty();
 
     if(condition){
-        auto it = block.parsedInputs.find("SUBSTACK");
-        if(it != block.parsedInputs.end()){
-            Block* subBlock = &sprite->blocks[it->second.blockId];
-            if(subBlock){
-                executor.runBlock(*subBlock,sprite);
-            }
-        }
+        thread->startBranch(sprite->shared->program[block.pc].substack, false);
     } else{
-        auto it = block.parsedInputs.find("SUBSTACK2");
-        if(it != block.parsedInputs.end()){
-            Block* subBlock = &sprite->blocks[it->second.blockId];
-            if(subBlock){
-                executor.runBlock(*subBlock,sprite);
-            }
-        }
+        thread->startBranch(sprite->shared->program[block.pc].substack2, false);
     }
-    return BlockResult::CONTINUE;
+    return BlockResult::BRANCH;
 }
 
-BlockResult ControlBlocks::createCloneOf(Block& block, Sprite* sprite, Block** waitingBlock, bool* withoutScreenRefresh){
+BlockResult ControlBlocks::createCloneOf(Block& block, Sprite* sprite, Thread* thread){
     //std::cout << "Trying " << std::endl;
 
     Block* cloneOptions = nullptr;
-    auto it = block.parsedInputs.find("CLONE_OPTION");
-    cloneOptions = &sprite->blocks[it->second.literalValue.asString()];
+    const ParsedInput* it = &block.inputs[Block::CLONE_OPTION];
+    cloneOptions = it->block;
+    if(!cloneOptions) return BlockResult::CONTINUE;
 
-    Sprite* spriteToClone = getAvailableSprite();
-    if(!spriteToClone) return BlockResult::CONTINUE;
-    if (cloneOptions->fields["CLONE_OPTION"][0] == "_myself_") {
-        *spriteToClone = *sprite;
-    } else {
-        for (Sprite* currentSprite : sprites) {
-            if (currentSprite->name == removeQuotations(cloneOptions->fields["CLONE_OPTION"][0]) && !currentSprite->isClone) {
-                *spriteToClone = *currentSprite;
-            }
-        }
-    }
-    spriteToClone->blockChains.clear();
+    Sprite* original = cloneOptions->option == Block::TARGET_MYSELF ? sprite : findOriginal(cloneOptions->target);
+    if(original == nullptr || original->isStage) return BlockResult::CONTINUE;
 
-    if (spriteToClone != nullptr && !spriteToClone->name.empty()) {
-        spriteToClone->isClone = true;
-        spriteToClone->isStage = false;
-        spriteToClone->toDelete = false;
-        spriteToClone->id = generateRandomString(15);
-        std::cout << "Created clone of " << sprite->name << std::endl;
-        // std::unordered_map<std::string, Block> newBlocks;
-        // for (auto& [id, block] : spriteToClone->blocks) {
-        //     if (block.opcode == block.CONTROL_START_AS_CLONE || block.opcode == block.EVENT_WHENBROADCASTRECEIVED || block.opcode == block.PROCEDURES_DEFINITION || block.opcode == block.PROCEDURES_PROTOTYPE) {
-        //         std::vector<Block*> blockChain = getBlockChain(block.id);
-        //         for (const Block* block : blockChain) {
-        //             newBlocks[block->id] = *block;
-        //         }
-        //     }
-        // }
-        // spriteToClone->blocks.clear();
-        // spriteToClone->blocks = newBlocks;
+    Sprite* clone = createClone(*original);
+    if(clone == nullptr) return BlockResult::CONTINUE;
+    // std::cout << "Created clone of " << sprite->name << std::endl;
 
-        // add clone to sprite list
-        sprites.push_back(spriteToClone);
-        Sprite* addedSprite = sprites.back();
-        // Run "when I start as a clone" scripts for the clone
-        for (Sprite* currentSprite : sprites) {
-            if (currentSprite == addedSprite) {
-                for (auto& [id, block] : currentSprite->blocks) {
-                    if (block.opcode == block.CONTROL_START_AS_CLONE) {
-                        // std::cout << "Running clone block " << block.id << std::endl;
-                        executor.runBlock(block, currentSprite);
-                    }
-                }
-            }
-        }
+    // Start "when I start as a clone" scripts for the clone, they get their turn later this frame
+    for (Block* hat : clone->shared->cloneHats) {
+        BlockExecutor::startThread(hat, clone);
     }
     return BlockResult::CONTINUE;
 }
-BlockResult ControlBlocks::deleteThisClone(Block& block, Sprite* sprite, Block** waitingBlock, bool* withoutScreenRefresh){
-    if(sprite->isClone)
-    sprite->toDelete = true;
-    return BlockResult::CONTINUE;
+BlockResult ControlBlocks::deleteThisClone(Block& block, Sprite* sprite, Thread* thread){
+    if(!sprite->isClone) return BlockResult::CONTINUE;
+    deleteClone(sprite);
+    return BlockResult::BREAK;
 }
 
-BlockResult ControlBlocks::stop(Block& block, Sprite* sprite, Block** waitingBlock, bool* withoutScreenRefresh){
-    std::string stopType = block.fields.at("STOP_OPTION")[0];
-    if(stopType == "all"){
+BlockResult ControlBlocks::stop(Block& block, Sprite* sprite, Thread* thread){
+    if(block.option == Block::STOP_ALL){
         toExit = true;
-        return BlockResult::RETURN;
+        return BlockResult::BREAK;
     }
-    if(stopType == "this script"){
-        for (std::string repeatID : sprite->blockChains[block.blockChainID].blocksToRepeat) {
-            Block* repeatBlock = &sprite->blocks[repeatID];
-            if (repeatBlock) {
-                repeatBlock->repeatTimes = -1;
-            }
-        }
-        sprite->blockChains[block.blockChainID].blocksToRepeat.clear();
-        return BlockResult::CONTINUE;
+    if(block.option == Block::STOP_THIS_SCRIPT){
+        // the ended frame makes the executor return to the caller
+        if(thread->returnFromProcedure()) return BlockResult::BRANCH;
+        return BlockResult::BREAK;
     }
 
-    if(stopType == "other scripts in sprite"){
-        for(auto& [id,chain] : sprite->blockChains){
-            if(id == block.blockChainID) continue;
-            for (std::string repeatID : chain.blocksToRepeat) {
-                Block* repeatBlock = &sprite->blocks[repeatID];
-                if (repeatBlock) {
-                    repeatBlock->repeatTimes = -1;
-                }
-            }
-            chain.blocksToRepeat.clear();
-        }
+    if(block.option == Block::STOP_OTHER_SCRIPTS){
+        BlockExecutor::stopOtherThreads(sprite, thread);
         return BlockResult::CONTINUE;
     }
     return BlockResult::CONTINUE;
 }
 
-BlockResult ControlBlocks::startAsClone(Block& block, Sprite* sprite, Block** waitingBlock, bool* withoutScreenRefresh){
+BlockResult ControlBlocks::startAsClone(Block& block, Sprite* sprite, Thread* thread){
     return BlockResult::CONTINUE;
 }
 
-BlockResult ControlBlocks::wait(Block& block, Sprite* sprite, Block** waitingBlock, bool* withoutScreenRefresh){
+BlockResult ControlBlocks::wait(Block& block, Sprite* sprite, Thread* thread){
     
-    if(block.repeatTimes == -1){
-        block.repeatTimes = -5;
+    BlockState& state = thread->state();
+    if(!state.started){
+        state.started = true;
         
-        Value duration = Scratch::getInputValue(block,"DURATION",sprite);
+        Value duration = Scratch::getInputValue(block, Block::DURATION, sprite);
         if(duration.isNumeric()) {
-            block.waitDuration = duration.asDouble() * 1000; // convert to milliseconds
+            state.waitDuration = duration.asDouble() * 1000; // convert to milliseconds
         } else {
-            block.waitDuration = 0;
+            state.waitDuration = 0;
         }
         
-        block.waitStartTime = std::chrono::high_resolution_clock::now();
-        
-        BlockExecutor::addToRepeatQueue(sprite, const_cast<Block*>(&block));
+        state.waitStartTime = std::chrono::high_resolution_clock::now();
     }
     
     auto currentTime = std::chrono::high_resolution_clock::now();
-    auto elapsedTime = std::chrono::duration_cast<std::chrono::milliseconds>(currentTime - block.waitStartTime).count();
+    auto elapsedTime = std::chrono::duration_cast<std::chrono::milliseconds>(currentTime - state.waitStartTime).count();
     
-    if (elapsedTime >= block.waitDuration) {
-        block.repeatTimes = -1;
-        sprite->blockChains[block.blockChainID].blocksToRepeat.pop_back();
+    if (elapsedTime >= state.waitDuration) {
         return BlockResult::CONTINUE;
     }
 
     return BlockResult::RETURN;
 }
 
-BlockResult ControlBlocks::waitUntil(Block& block, Sprite* sprite, Block** waitingBlock, bool* withoutScreenRefresh){
-    
-    if(block.repeatTimes == -1){
-        block.repeatTimes = -4;
-        BlockExecutor::addToRepeatQueue(sprite, const_cast<Block*>(&block));
-    }
-    
+BlockResult ControlBlocks::waitUntil(Block& block, Sprite* sprite, Thread* thread){
 
-    Value conditionValue = Scratch::getInputValue(block, "CONDITION", sprite);
+    Value conditionValue = Scratch::getInputValue(block, Block::CONDITION, sprite);
     
     bool conditionMet = false;
     if (conditionValue.isNumeric()) {
@@ -191,91 +116,50 @@ BlockResult ControlBlocks::waitUntil(Block& block, Sprite* sprite, Block** waiti
     }
     
     if (conditionMet) {
-        block.repeatTimes = -1;
-        sprite->blockChains[block.blockChainID].blocksToRepeat.pop_back();
         return BlockResult::CONTINUE;
     }
     
     return BlockResult::RETURN;
 }
 
-BlockResult ControlBlocks::repeat(Block& block, Sprite* sprite, Block** waitingBlock, bool* withoutScreenRefresh){
+BlockResult ControlBlocks::repeat(Block& block, Sprite* sprite, Thread* thread){
 
-    if(block.repeatTimes == -1){
-        block.repeatTimes = Scratch::getInputValue(block, "TIMES", sprite).asInt();
-        BlockExecutor::addToRepeatQueue(sprite,&block);
+    BlockState& state = thread->state();
+    if(!state.started){
+        state.started = true;
+        state.repeatTimes = Scratch::getInputValue(block, Block::TIMES, sprite).asInt();
     }
 
-    if (block.repeatTimes > 0) {
-        auto it = block.parsedInputs.find("SUBSTACK");
-        if(it != block.parsedInputs.end()){
-            Block* subBlock = &sprite->blocks[it->second.blockId];
-            if(subBlock){
-                executor.runBlock(*subBlock,sprite);
-            }
-        }
-
+    if (state.repeatTimes > 0) {
         // Countdown
-        block.repeatTimes -= 1;
-        return BlockResult::RETURN;
-} else {
-        block.repeatTimes = -1;
+        state.repeatTimes -= 1;
+        thread->startBranch(sprite->shared->program[block.pc].substack, true);
+        return BlockResult::BRANCH;
     }
     //std::cout << "done with repeat " << block.id << std::endl;
-    sprite->blockChains[block.blockChainID].blocksToRepeat.pop_back();
     return BlockResult::CONTINUE;
 
 }
 
-BlockResult ControlBlocks::repeatUntil(Block& block, Sprite* sprite, Block** waitingBlock, bool* withoutScreenRefresh){
+BlockResult ControlBlocks::repeatUntil(Block& block, Sprite* sprite, Thread* thread){
 
-    if(block.repeatTimes == -1){
-        block.repeatTimes = -2;
-        BlockExecutor::addToRepeatQueue(sprite, &block);
-        std::cout << "added to repeat queue!" << std::endl;
-    }
-
-    Value conditionValue = Scratch::getInputValue(block,"CONDITION",sprite);
+    Value conditionValue = Scratch::getInputValue(block, Block::CONDITION, sprite);
     bool condition = false;
     if(conditionValue.isNumeric()){
         condition = conditionValue.asDouble() != 0.0;
     } else condition = !conditionValue.asString().empty();
     
     if (condition) {
-        block.repeatTimes = -1;
-        sprite->blockChains[block.blockChainID].blocksToRepeat.pop_back();
         return BlockResult::CONTINUE;
     }
     
-        auto it = block.parsedInputs.find("SUBSTACK");
-        if(it != block.parsedInputs.end()){
-            const std::string& blockId = it->second.blockId;
-            auto blockIt = sprite->blocks.find(blockId);
-            if (blockIt != sprite->blocks.end()) {
-                Block* subBlock = &blockIt->second;
-                executor.runBlock(*subBlock, sprite);
-            } else {
-                std::cerr << "Invalid blockId: " << blockId << std::endl;
-            }
-        }
-    
     // Continue the loop
-    return BlockResult::RETURN;
+    thread->startBranch(sprite->shared->program[block.pc].substack, true);
+    return BlockResult::BRANCH;
 }
 
-BlockResult ControlBlocks::forever(Block& block, Sprite* sprite, Block** waitingBlock, bool* withoutScreenRefresh){
-
-    if(block.repeatTimes == -1){
-        block.repeatTimes = -3;
-        BlockExecutor::addToRepeatQueue(sprite, &block);
-    }
+BlockResult ControlBlocks::forever(Block& block, Sprite* sprite, Thread* thread){
 
-    auto it = block.parsedInputs.find("SUBSTACK");
-    if(it != block.parsedInputs.end()){
-        Block* subBlock = &sprite->blocks[it->second.blockId];
-        if(subBlock){
-            executor.runBlock(*subBlock,sprite);
-        }
-    }
-    return BlockResult::RETURN;
+    thread->startBranch(sprite->shared->program[block.pc].substack, true);
+    return BlockResult::BRANCH;
 }
\ No newline at end of file
@@ -1,42 +1,31 @@
 #include "events.hpp"
-#include "../input.hpp"
 
-BlockResult EventBlocks::flagClicked(Block& block, Sprite* sprite, Block** waitingBlock, bool* withoutScreenRefresh){
+BlockResult EventBlocks::flagClicked(Block& block, Sprite* sprite, Thread* thread){
     return BlockResult::CONTINUE;
 }
 
-BlockResult EventBlocks::broadcast(Block& block, Sprite* sprite, Block** waitingBlock, bool* withoutScreenRefresh){
-    broadcastQueue.push_back( Scratch::getInputValue(block,"BROADCAST_INPUT",sprite).asString());
+BlockResult EventBlocks::broadcast(Block& block, Sprite* sprite, Thread* thread){
+    // nothing to do for a message no hat listens to
+    broadcastQueue.push(findBroadcast(Scratch::getInputValue(block, Block::BROADCAST_INPUT, sprite).asString()));
     return BlockResult::CONTINUE;
 }
 
-BlockResult EventBlocks::broadcastAndWait(Block& block, Sprite* sprite, Block** waitingBlock, bool* withoutScreenRefresh){
-    if(block.repeatTimes == -1){
-        block.repeatTimes = -10;
-        BlockExecutor::addToRepeatQueue(sprite,&block);
-        broadcastQueue.push_back( Scratch::getInputValue(block,"BROADCAST_INPUT",sprite).asString());
-        block.broadcastsRun = BlockExecutor::runBroadcasts();
+BlockResult EventBlocks::broadcastAndWait(Block& block, Sprite* sprite, Thread* thread){
+    BlockState& state = thread->state();
+    if(!state.started){
+        state.started = true;
+        // started right away instead of queued, so there's something to wait for
+        int message = findBroadcast(Scratch::getInputValue(block, Block::BROADCAST_INPUT, sprite).asString());
+        if(message != -1) state.broadcastsRun = BlockExecutor::startBroadcast(message);
     }
 
-    bool shouldEnd = true;
-    for(auto& [blockPtr, spritePtr] : block.broadcastsRun){
-        if(!spritePtr->blockChains[blockPtr->blockChainID].blocksToRepeat.empty()){
-            shouldEnd = false;
-        }
+    for(auto& [blockPtr, spritePtr] : state.broadcastsRun){
+        if(BlockExecutor::isRunning(blockPtr, spritePtr)) return BlockResult::RETURN;
     }
-
-    if(!shouldEnd) return BlockResult::RETURN;
-
-    block.repeatTimes = -1;
-    sprite->blockChains[block.blockChainID].blocksToRepeat.pop_back();
     return BlockResult::CONTINUE;
 }
 
-BlockResult EventBlocks::whenKeyPressed(Block& block, Sprite* sprite, Block** waitingBlock, bool* withoutScreenRefresh){
-    for (std::string button : Input::inputButtons) {
-        if (block.fields.at("KEY_OPTION")[0] == button) {
-            return BlockResult::CONTINUE;
-        }
-    }
-    return BlockResult::RETURN;
+BlockResult EventBlocks::whenKeyPressed(Block& block, Sprite* sprite, Thread* thread){
+    // only started for the keys it listens to, see BlockExecutor::runKeyPressedHats
+    return BlockResult::CONTINUE;
 }
\ No newline at end of file
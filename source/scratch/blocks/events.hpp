@@ -3,8 +3,8 @@
 
 class EventBlocks{
 public:
-    static BlockResult flagClicked(Block& block, Sprite* sprite, Block** waitingBlock, bool* withoutScreenRefresh);
-    static BlockResult broadcast(Block& block, Sprite* sprite, Block** waitingBlock, bool* withoutScreenRefresh);
-    static BlockResult broadcastAndWait(Block& block, Sprite* sprite, Block** waitingBlock, bool* withoutScreenRefresh);
-    static BlockResult whenKeyPressed(Block& block, Sprite* sprite, Block** waitingBlock, bool* withoutScreenRefresh);
+    static BlockResult flagClicked(Block& block, Sprite* sprite, Thread* thread);
+    static BlockResult broadcast(Block& block, Sprite* sprite, Thread* thread);
+    static BlockResult broadcastAndWait(Block& block, Sprite* sprite, Thread* thread);
+    static BlockResult whenKeyPressed(Block& block, Sprite* sprite, Thread* thread);
 };
\ No newline at end of file
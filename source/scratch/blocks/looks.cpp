@@ -1,33 +1,33 @@
 #include "looks.hpp"
 
 
-BlockResult LooksBlocks::show(Block& block, Sprite* sprite, Block** waitingBlock, bool* withoutScreenRefresh) {
+BlockResult LooksBlocks::show(Block& block, Sprite* sprite, Thread* thread) {
     sprite->visible = true;
     return BlockResult::CONTINUE;
 }
-BlockResult LooksBlocks::hide(Block& block, Sprite* sprite, Block** waitingBlock, bool* withoutScreenRefresh) {
+BlockResult LooksBlocks::hide(Block& block, Sprite* sprite, Thread* thread) {
     sprite->visible = false;
     return BlockResult::CONTINUE;
 }
 
-BlockResult LooksBlocks::switchCostumeTo(Block& block, Sprite* sprite, Block** waitingBlock, bool* withoutScreenRefresh){
-    Value inputValue = Scratch::getInputValue(block,"COSTUME",sprite);
+BlockResult LooksBlocks::switchCostumeTo(Block& block, Sprite* sprite, Thread* thread){
+    Value inputValue = Scratch::getInputValue(block, Block::COSTUME, sprite);
     std::string inputString = inputValue.asString();
 
-    auto inputFind = block.parsedInputs.find("COSTUME");
-    if(inputFind != block.parsedInputs.end() && inputFind->second.inputType == ParsedInput::LITERAL){
-        Block* inputBlock = findBlock(inputValue.asString());
+    const ParsedInput* inputFind = &block.inputs[Block::COSTUME];
+    if(inputFind->inputType == ParsedInput::LITERAL){
+        Block* inputBlock = inputFind->block;
         if(inputBlock != nullptr){
-            inputString = inputBlock->fields["COSTUME"][0].get<std::string>();
+            inputString = inputBlock->field;
         }
     }
 
 
     bool foundImage = false;
-        for (size_t i = 0; i < sprite->costumes.size(); i++) {
-            if (sprite->costumes[i].name == inputString) {
+        for (size_t i = 0; i < sprite->shared->costumes.size(); i++) {
+            if (sprite->shared->costumes[i].name == inputString) {
                 if((size_t)sprite->currentCostume != i){
-                   // Image::queueFreeImage(sprite->costumes[sprite->currentCostume].id);
+                   // Image::queueFreeImage(sprite->shared->costumes[sprite->currentCostume].id);
                 }
                 sprite->currentCostume = i;
                 foundImage = true;
@@ -36,9 +36,9 @@ BlockResult LooksBlocks::switchCostumeTo(Block& block, Sprite* sprite, Block** w
         }
         if(!foundImage && inputValue.isNumeric()){
             int costumeIndex = inputValue.asInt() - 1;
-            if (costumeIndex >= 0 && static_cast<size_t>(costumeIndex) < sprite->costumes.size()) {
+            if (costumeIndex >= 0 && static_cast<size_t>(costumeIndex) < sprite->shared->costumes.size()) {
                 if(sprite->currentCostume != costumeIndex){
-                   // Image::queueFreeImage(sprite->costumes[sprite->currentCostume].id);
+                   // Image::queueFreeImage(sprite->shared->costumes[sprite->currentCostume].id);
             }
             foundImage = true;
             sprite->currentCostume = costumeIndex;
@@ -46,94 +46,87 @@ BlockResult LooksBlocks::switchCostumeTo(Block& block, Sprite* sprite, Block** w
         }
 
         if(projectType == UNZIPPED){
-            Image::loadImageFromFile(sprite->costumes[sprite->currentCostume].id);
+            Image::loadImageFromFile(sprite->shared->costumes[sprite->currentCostume].id);
         }
 
     return BlockResult::CONTINUE;
 }
 
-BlockResult LooksBlocks::nextCostume(Block& block, Sprite* sprite, Block** waitingBlock, bool* withoutScreenRefresh) {
-    //Image::queueFreeImage(sprite->costumes[sprite->currentCostume].id);
+BlockResult LooksBlocks::nextCostume(Block& block, Sprite* sprite, Thread* thread) {
+    //Image::queueFreeImage(sprite->shared->costumes[sprite->currentCostume].id);
     sprite->currentCostume++;
-    if (sprite->currentCostume >= static_cast<int>(sprite->costumes.size())) {
+    if (sprite->currentCostume >= static_cast<int>(sprite->shared->costumes.size())) {
         sprite->currentCostume = 0;
     }
     if(projectType == UNZIPPED){
-        Image::loadImageFromFile(sprite->costumes[sprite->currentCostume].id);
+        Image::loadImageFromFile(sprite->shared->costumes[sprite->currentCostume].id);
     }
     return BlockResult::CONTINUE;
 }
 
-BlockResult LooksBlocks::switchBackdropTo(Block& block, Sprite* sprite, Block** waitingBlock, bool* withoutScreenRefresh){
-    Value inputValue = Scratch::getInputValue(block, "BACKDROP", sprite);
+BlockResult LooksBlocks::switchBackdropTo(Block& block, Sprite* sprite, Thread* thread){
+    Value inputValue = Scratch::getInputValue(block, Block::BACKDROP, sprite);
     std::string inputString = inputValue.asString();
     
-    auto inputFind = block.parsedInputs.find("BACKDROP");
-    if(inputFind != block.parsedInputs.end() && inputFind->second.inputType == ParsedInput::LITERAL){
-        Block* inputBlock = findBlock(inputValue.asString());
+    const ParsedInput* inputFind = &block.inputs[Block::BACKDROP];
+    if(inputFind->inputType == ParsedInput::LITERAL){
+        Block* inputBlock = inputFind->block;
         if(inputBlock != nullptr){
-            inputString = inputBlock->fields["BACKDROP"][0].get<std::string>();
+            inputString = inputBlock->field;
         }
     }
     
-    for(Sprite* currentSprite : sprites){
-        if(!currentSprite->isStage){
-            continue;
-        }
-        
-        bool foundImage = false;
-        
-        for (size_t i = 0; i < currentSprite->costumes.size(); i++) {
-            if (currentSprite->costumes[i].name == inputString) {
-                if((size_t)currentSprite->currentCostume != i){
-                   // Image::queueFreeImage(currentSprite->costumes[currentSprite->currentCostume].id);
-                }
-                currentSprite->currentCostume = i;
-                foundImage = true;
-                break;
+    Sprite* stage = Scratch::stage;
+    if(stage == nullptr) return BlockResult::CONTINUE;
+
+    bool foundImage = false;
+
+    for (size_t i = 0; i < stage->shared->costumes.size(); i++) {
+        if (stage->shared->costumes[i].name == inputString) {
+            if((size_t)stage->currentCostume != i){
+               // Image::queueFreeImage(stage->shared->costumes[stage->currentCostume].id);
             }
+            stage->currentCostume = i;
+            foundImage = true;
+            break;
         }
-        if(!foundImage && inputValue.isNumeric()){
-            int costumeIndex = inputValue.asInt() - 1;
-            if (costumeIndex >= 0 && static_cast<size_t>(costumeIndex) < currentSprite->costumes.size()) {
-                if(currentSprite->currentCostume != costumeIndex){
-                    //Image::queueFreeImage(currentSprite->costumes[currentSprite->currentCostume].id);
-                }
-                foundImage = true;
-                currentSprite->currentCostume = costumeIndex;
+    }
+    if(!foundImage && inputValue.isNumeric()){
+        int costumeIndex = inputValue.asInt() - 1;
+        if (costumeIndex >= 0 && static_cast<size_t>(costumeIndex) < stage->shared->costumes.size()) {
+            if(stage->currentCostume != costumeIndex){
+                //Image::queueFreeImage(stage->shared->costumes[stage->currentCostume].id);
             }
-        }
-        
-        if(projectType == UNZIPPED){
-            Image::loadImageFromFile(currentSprite->costumes[currentSprite->currentCostume].id);
+            foundImage = true;
+            stage->currentCostume = costumeIndex;
         }
     }
+
+    if(projectType == UNZIPPED){
+        Image::loadImageFromFile(stage->shared->costumes[stage->currentCostume].id);
+    }
     
     return BlockResult::CONTINUE;
 }
 
-BlockResult LooksBlocks::nextBackdrop(Block& block, Sprite* sprite, Block** waitingBlock, bool* withoutScreenRefresh) {
-    for(Sprite* currentSprite : sprites){
-        if(!currentSprite->isStage){
-            continue;
-        }
-        //Image::queueFreeImage(currentSprite->costumes[currentSprite->currentCostume].id);
-        currentSprite->currentCostume++;
-        if (currentSprite->currentCostume >= static_cast<int>(currentSprite->costumes.size())) {
-            currentSprite->currentCostume = 0;
-        }
-        if(projectType == UNZIPPED){
-            Image::loadImageFromFile(currentSprite->costumes[currentSprite->currentCostume].id);
-        }
-}
+BlockResult LooksBlocks::nextBackdrop(Block& block, Sprite* sprite, Thread* thread) {
+    Sprite* stage = Scratch::stage;
+    if(stage == nullptr) return BlockResult::CONTINUE;
+    //Image::queueFreeImage(stage->shared->costumes[stage->currentCostume].id);
+    stage->currentCostume++;
+    if (stage->currentCostume >= static_cast<int>(stage->shared->costumes.size())) {
+        stage->currentCostume = 0;
+    }
+    if(projectType == UNZIPPED){
+        Image::loadImageFromFile(stage->shared->costumes[stage->currentCostume].id);
+    }
     return BlockResult::CONTINUE;
 }
 
-BlockResult LooksBlocks::goForwardBackwardLayers(Block& block, Sprite* sprite, Block** waitingBlock, bool* withoutScreenRefresh){
-    Value value = Scratch::getInputValue(block,"NUM",sprite);
-    std::string forwardBackward = block.fields.at("FORWARD_BACKWARD")[0];
+BlockResult LooksBlocks::goForwardBackwardLayers(Block& block, Sprite* sprite, Thread* thread){
+    Value value = Scratch::getInputValue(block, Block::NUM, sprite);
     if (value.isNumeric()) {
-    if (forwardBackward == "forward") {
+    if (block.option == Block::LAYER_FORWARD) {
 
         // check if a sprite is already on the same layer
         for(Sprite* currentSprite : sprites){
@@ -148,7 +141,7 @@ BlockResult LooksBlocks::goForwardBackwardLayers(Block& block, Sprite* sprite, B
 
         sprite->layer += value.asInt();
 
-    } else if (forwardBackward == "backward") {
+    } else if (block.option == Block::LAYER_BACKWARD) {
 
         // check if a sprite is already on the same layer
         for(Sprite* currentSprite : sprites){
@@ -174,9 +167,8 @@ BlockResult LooksBlocks::goForwardBackwardLayers(Block& block, Sprite* sprite, B
     return BlockResult::CONTINUE;
 }
 
-BlockResult LooksBlocks::goToFrontBack(Block& block, Sprite* sprite, Block** waitingBlock, bool* withoutScreenRefresh){
-    std::string value = block.fields.at("FRONT_BACK")[0];
-    if (value == "front") {
+BlockResult LooksBlocks::goToFrontBack(Block& block, Sprite* sprite, Thread* thread){
+    if (block.option == Block::LAYER_FRONT) {
 
         double maxLayer = 0.0;
         for (Sprite* currentSprite : sprites) {
@@ -187,7 +179,7 @@ BlockResult LooksBlocks::goToFrontBack(Block& block, Sprite* sprite, Block** wai
 
         sprite->layer = maxLayer + 1;
 
-    } else if (value == "back") {
+    } else if (block.option == Block::LAYER_BACK) {
         for(Sprite* currentSprite : sprites){
             if(currentSprite->isStage) continue;
             currentSprite->layer+= 2;
@@ -197,8 +189,8 @@ BlockResult LooksBlocks::goToFrontBack(Block& block, Sprite* sprite, Block** wai
     return BlockResult::CONTINUE;
 }
 
-BlockResult LooksBlocks::setSizeTo(Block& block, Sprite* sprite, Block** waitingBlock, bool* withoutScreenRefresh) {
-    Value value = Scratch::getInputValue(block, "SIZE", sprite);
+BlockResult LooksBlocks::setSizeTo(Block& block, Sprite* sprite, Thread* thread) {
+    Value value = Scratch::getInputValue(block, Block::SIZE, sprite);
     if (value.isNumeric()) {
         const double inputSizePercent = value.asDouble();
 
@@ -212,8 +204,8 @@ BlockResult LooksBlocks::setSizeTo(Block& block, Sprite* sprite, Block** waiting
     return BlockResult::CONTINUE;
 }
 
-BlockResult LooksBlocks::changeSizeBy(Block& block, Sprite* sprite, Block** waitingBlock, bool* withoutScreenRefresh) {
-    Value value = Scratch::getInputValue(block, "CHANGE", sprite);
+BlockResult LooksBlocks::changeSizeBy(Block& block, Sprite* sprite, Thread* thread) {
+    Value value = Scratch::getInputValue(block, Block::CHANGE, sprite);
     if (value.isNumeric()) {
         sprite->size += value.asDouble();
 
@@ -226,26 +218,25 @@ BlockResult LooksBlocks::changeSizeBy(Block& block, Sprite* sprite, Block** wait
     return BlockResult::CONTINUE;
 }
 
-BlockResult LooksBlocks::setEffectTo(Block& block, Sprite* sprite, Block** waitingBlock, bool* withoutScreenRefresh){
+BlockResult LooksBlocks::setEffectTo(Block& block, Sprite* sprite, Thread* thread){
     
-    std::string effect = block.fields.at("EFFECT")[0];
-    Value amount = Scratch::getInputValue(block,"VALUE",sprite);
+    Value amount = Scratch::getInputValue(block, Block::VALUE, sprite);
 
     if(!amount.isNumeric()) return BlockResult::CONTINUE;
 
-    if (effect == "COLOR") {
+    if (block.option == Block::EFFECT_COLOR) {
         // doable....
-    } else if (effect == "FISHEYE") {
+    } else if (block.option == Block::EFFECT_FISHEYE) {
         // blehhh
-    } else if (effect == "WHIRL") {
+    } else if (block.option == Block::EFFECT_WHIRL) {
         // blehhh
-    }else if (effect == "PIXELATE") {
+    }else if (block.option == Block::EFFECT_PIXELATE) {
         // blehhh
-    }else if (effect == "MOSAIC") {
+    }else if (block.option == Block::EFFECT_MOSAIC) {
         // blehhh
-    }else if (effect == "BRIGHTNESS") {
+    }else if (block.option == Block::EFFECT_BRIGHTNESS) {
         // doable....
-    }else if (effect == "GHOST") {
+    }else if (block.option == Block::EFFECT_GHOST) {
         sprite->ghostEffect = std::clamp(amount.asInt(),0,100);
     }
     else {
@@ -255,25 +246,24 @@ BlockResult LooksBlocks::setEffectTo(Block& block, Sprite* sprite, Block** waiti
 return BlockResult::CONTINUE;
 
 }
-BlockResult LooksBlocks::changeEffectBy(Block& block, Sprite* sprite, Block** waitingBlock, bool* withoutScreenRefresh){
-    std::string effect = block.fields.at("EFFECT")[0];
-    Value amount = Scratch::getInputValue(block,"CHANGE",sprite);
+BlockResult LooksBlocks::changeEffectBy(Block& block, Sprite* sprite, Thread* thread){
+    Value amount = Scratch::getInputValue(block, Block::CHANGE, sprite);
 
     if(!amount.isNumeric()) return BlockResult::CONTINUE;
 
-    if (effect == "COLOR") {
+    if (block.option == Block::EFFECT_COLOR) {
         // doable....
-    } else if (effect == "FISHEYE") {
+    } else if (block.option == Block::EFFECT_FISHEYE) {
         // blehhh
-    } else if (effect == "WHIRL") {
+    } else if (block.option == Block::EFFECT_WHIRL) {
         // blehhh
-    }else if (effect == "PIXELATE") {
+    }else if (block.option == Block::EFFECT_PIXELATE) {
         // blehhh
-    }else if (effect == "MOSAIC") {
+    }else if (block.option == Block::EFFECT_MOSAIC) {
         // blehhh
-    }else if (effect == "BRIGHTNESS") {
+    }else if (block.option == Block::EFFECT_BRIGHTNESS) {
         // doable....
-    }else if (effect == "GHOST") {
+    }else if (block.option == Block::EFFECT_GHOST) {
         sprite->ghostEffect += amount.asInt();
         sprite->ghostEffect = std::clamp(sprite->ghostEffect,0,100);
     }
@@ -282,7 +272,7 @@ BlockResult LooksBlocks::changeEffectBy(Block& block, Sprite* sprite, Block** wa
     }
 return BlockResult::CONTINUE;
 }
-BlockResult LooksBlocks::clearGraphicEffects(Block& block, Sprite* sprite, Block** waitingBlock, bool* withoutScreenRefresh){
+BlockResult LooksBlocks::clearGraphicEffects(Block& block, Sprite* sprite, Thread* thread){
 
 sprite->ghostEffect = 0;
 sprite->colorEffect = -99999;
@@ -295,38 +285,30 @@ Value LooksBlocks::size(Block& block, Sprite* sprite) {
 }
 
 Value LooksBlocks::costume(Block& block, Sprite* sprite) {
-    return Value(block.fields.at("COSTUME")[0].get<std::string>());
+    return Value(block.field);
 }
 
 Value LooksBlocks::backdrops(Block& block, Sprite* sprite) {
-    return Value(block.fields.at("BACKDROP")[0].get<std::string>());
+    return Value(block.field);
 }
 
 Value LooksBlocks::costumeNumberName(Block& block, Sprite* sprite) {
-    std::string value = block.fields.at("NUMBER_NAME")[0];
-    if (value == "name") {
-        std::cout << sprite->costumes[sprite->currentCostume].name << std::endl;
-        return Value(sprite->costumes[sprite->currentCostume].name);
-    } else if (value == "number") {
+    if (block.option == Block::NAME) {
+        std::cout << sprite->shared->costumes[sprite->currentCostume].name << std::endl;
+        return Value(sprite->shared->costumes[sprite->currentCostume].name);
+    } else if (block.option == Block::NUMBER) {
         return Value(sprite->currentCostume + 1);
     }
     return Value();
 }
 
 Value LooksBlocks::backdropNumberName(Block& block, Sprite* sprite) {
-    std::string value = block.fields.at("NUMBER_NAME")[0];
-    if (value == "name") {
-        for (Sprite* currentSprite : sprites) {
-            if (currentSprite->isStage) {
-                return Value(currentSprite->costumes[currentSprite->currentCostume].name);
-            }
-        }
-    } else if (value == "number") {
-        for (Sprite* currentSprite : sprites) {
-            if (currentSprite->isStage) {
-                return Value(currentSprite->currentCostume + 1);
-            }
-        }
+    Sprite* stage = Scratch::stage;
+    if (stage == nullptr) return Value();
+    if (block.option == Block::NAME) {
+        return Value(stage->shared->costumes[stage->currentCostume].name);
+    } else if (block.option == Block::NUMBER) {
+        return Value(stage->currentCostume + 1);
     }
     return Value();
 }
\ No newline at end of file
@@ -1,8 +1,8 @@
 #include "motion.hpp"
 #include "../scratch/input.hpp"
 
-BlockResult MotionBlocks::moveSteps(Block& block, Sprite* sprite, Block** waitingBlock, bool* withoutScreenRefresh){
-    Value value = Scratch::getInputValue(block,"STEPS",sprite);
+BlockResult MotionBlocks::moveSteps(Block& block, Sprite* sprite, Thread* thread){
+    Value value = Scratch::getInputValue(block, Block::STEPS, sprite);
             if (value.isNumeric()) {
                 double angle = (sprite->rotation - 90) * M_PI / 180.0;
                 sprite->xPosition += std::cos(angle) * value.asDouble();
@@ -15,67 +15,62 @@ BlockResult MotionBlocks::moveSteps(Block& block, Sprite* sprite, Block** waitin
 
 }
 
-BlockResult MotionBlocks::goTo(Block& block, Sprite* sprite, Block** waitingBlock, bool* withoutScreenRefresh){
-    auto inputValue = block.parsedInputs.find("TO");
-    Block* inputBlock = findBlock(inputValue->second.literalValue.asString());
-            std::string objectName = inputBlock->fields["TO"][0];
-
-            if (objectName == "_random_") {
+BlockResult MotionBlocks::goTo(Block& block, Sprite* sprite, Thread* thread){
+    const ParsedInput* inputValue = &block.inputs[Block::TO];
+    Block* inputBlock = inputValue->block;
+            if (inputBlock->option == Block::TARGET_RANDOM) {
                 sprite->xPosition = rand() % Scratch::projectWidth - Scratch::projectWidth / 2;
                 sprite->yPosition = rand() % Scratch::projectHeight - Scratch::projectHeight / 2;
                 return BlockResult::CONTINUE;
             }
 
-            if (objectName == "_mouse_") {
+            if (inputBlock->option == Block::TARGET_MOUSE) {
                 sprite->xPosition = Input::mousePointer.x;
                 sprite->yPosition = Input::mousePointer.y;
                 return BlockResult::CONTINUE;
             }
 
-            for (Sprite* currentSprite : sprites) {
-                if (currentSprite->name == objectName) {
-                    sprite->xPosition = currentSprite->xPosition;
-                    sprite->yPosition = currentSprite->yPosition;
-                    break;
-                }
+            if (Sprite* target = findOriginal(inputBlock->target)) {
+                sprite->xPosition = target->xPosition;
+                sprite->yPosition = target->yPosition;
             }
     return BlockResult::CONTINUE;
 }
 
-BlockResult MotionBlocks::goToXY(Block& block, Sprite* sprite, Block** waitingBlock, bool* withoutScreenRefresh){
-    Value xVal = Scratch::getInputValue(block,"X",sprite);
-    Value yVal = Scratch::getInputValue(block,"Y",sprite);
+BlockResult MotionBlocks::goToXY(Block& block, Sprite* sprite, Thread* thread){
+    Value xVal = Scratch::getInputValue(block, Block::X, sprite);
+    Value yVal = Scratch::getInputValue(block, Block::Y, sprite);
     if (xVal.isNumeric()) sprite->xPosition = xVal.asDouble();
     if (yVal.isNumeric()) sprite->yPosition = yVal.asDouble();
     return BlockResult::CONTINUE;
 }
 
-BlockResult MotionBlocks::turnLeft(Block& block, Sprite* sprite, Block** waitingBlock, bool* withoutScreenRefresh){
-    Value value = Scratch::getInputValue(block,"DEGREES",sprite);
+BlockResult MotionBlocks::turnLeft(Block& block, Sprite* sprite, Thread* thread){
+    Value value = Scratch::getInputValue(block, Block::DEGREES, sprite);
     if (value.isNumeric()) {
         sprite->rotation -= value.asDouble();
     }
     return BlockResult::CONTINUE;
 }
 
-BlockResult MotionBlocks::turnRight(Block& block, Sprite* sprite, Block** waitingBlock, bool* withoutScreenRefresh){
-    Value value = Scratch::getInputValue(block,"DEGREES",sprite);
+BlockResult MotionBlocks::turnRight(Block& block, Sprite* sprite, Thread* thread){
+    Value value = Scratch::getInputValue(block, Block::DEGREES, sprite);
     if (value.isNumeric()) {
         sprite->rotation += value.asDouble();
     }
     return BlockResult::CONTINUE;
 }
 
-BlockResult MotionBlocks::pointInDirection(Block& block, Sprite* sprite, Block** waitingBlock, bool* withoutScreenRefresh){
-    Value value = Scratch::getInputValue(block,"DIRECTION", sprite);
+BlockResult MotionBlocks::pointInDirection(Block& block, Sprite* sprite, Thread* thread){
+    Value value = Scratch::getInputValue(block, Block::DIRECTION, sprite);
     if (value.isNumeric()) {
         sprite->rotation = value.asDouble();
     }
     return BlockResult::CONTINUE;
 }
 
-BlockResult MotionBlocks::changeXBy(Block& block, Sprite* sprite, Block** waitingBlock, bool* withoutScreenRefresh) {
-    Value value = Scratch::getInputValue(block,"DX", sprite);
+BlockResult MotionBlocks::changeXBy(Block& block, Sprite* sprite, Thread* thread) {
+    Value value = Scratch::getInputValue(block, Block::DX, sprite);
     if (value.isNumeric()) {
         sprite->xPosition += value.asDouble();
     } else {
@@ -84,8 +79,8 @@ BlockResult MotionBlocks::changeXBy(Block& block, Sprite* sprite, Block** waitin
     return BlockResult::CONTINUE;
 }
 
-BlockResult MotionBlocks::changeYBy(Block& block, Sprite* sprite, Block** waitingBlock, bool* withoutScreenRefresh) {
-    Value value = Scratch::getInputValue(block,"DY", sprite);
+BlockResult MotionBlocks::changeYBy(Block& block, Sprite* sprite, Thread* thread) {
+    Value value = Scratch::getInputValue(block, Block::DY, sprite);
     if (value.isNumeric()) {
         sprite->yPosition += value.asDouble();
     } else {
@@ -94,8 +89,8 @@ BlockResult MotionBlocks::changeYBy(Block& block, Sprite* sprite, Block** waitin
     return BlockResult::CONTINUE;
 }
 
-BlockResult MotionBlocks::setX(Block& block, Sprite* sprite, Block** waitingBlock, bool* withoutScreenRefresh) {
-    Value value = Scratch::getInputValue(block,"X", sprite);
+BlockResult MotionBlocks::setX(Block& block, Sprite* sprite, Thread* thread) {
+    Value value = Scratch::getInputValue(block, Block::X, sprite);
     if (value.isNumeric()) {
         sprite->xPosition = value.asDouble();
     } else {
@@ -104,8 +99,8 @@ BlockResult MotionBlocks::setX(Block& block, Sprite* sprite, Block** waitingBloc
     return BlockResult::CONTINUE;
 }
 
-BlockResult MotionBlocks::setY(Block& block, Sprite* sprite, Block** waitingBlock, bool* withoutScreenRefresh) {
-    Value value = Scratch::getInputValue(block,"Y", sprite);
+BlockResult MotionBlocks::setY(Block& block, Sprite* sprite, Thread* thread) {
+    Value value = Scratch::getInputValue(block, Block::Y, sprite);
     if (value.isNumeric()) {
         sprite->yPosition = value.asDouble();
     } else {
@@ -114,150 +109,130 @@ BlockResult MotionBlocks::setY(Block& block, Sprite* sprite, Block** waitingBloc
     return BlockResult::CONTINUE;
 }
 
-BlockResult MotionBlocks::glideSecsToXY(Block& block, Sprite* sprite, Block** waitingBlock, bool* withoutScreenRefresh){
+BlockResult MotionBlocks::glideSecsToXY(Block& block, Sprite* sprite, Thread* thread){
     
-    if(block.repeatTimes == -1){
-        block.repeatTimes = -6;
+    BlockState& state = thread->state();
+    if(!state.started){
+        state.started = true;
         
-        Value duration = Scratch::getInputValue(block,"SECS",sprite);
+        Value duration = Scratch::getInputValue(block, Block::SECS, sprite);
         if(duration.isNumeric()) {
-            block.waitDuration = duration.asDouble() * 1000;
+            state.waitDuration = duration.asDouble() * 1000;
         } else {
-            block.waitDuration = 0;
+            state.waitDuration = 0;
         }
         
-        block.waitStartTime = std::chrono::high_resolution_clock::now();
-        block.glideStartX = sprite->xPosition;
-        block.glideStartY = sprite->yPosition;
+        state.waitStartTime = std::chrono::high_resolution_clock::now();
+        state.glideStartX = sprite->xPosition;
+        state.glideStartY = sprite->yPosition;
         
         // Get target positions
-        Value positionXStr = Scratch::getInputValue(block,"X",sprite);
-        Value positionYStr = Scratch::getInputValue(block,"Y",  sprite);
-        block.glideEndX = positionXStr.isNumeric() ? positionXStr.asDouble() : block.glideStartX;
-        block.glideEndY = positionYStr.isNumeric() ? positionYStr.asDouble() : block.glideStartY;
-        
-        BlockExecutor::addToRepeatQueue(sprite, const_cast<Block*>(&block));
+        Value positionXStr = Scratch::getInputValue(block, Block::X, sprite);
+        Value positionYStr = Scratch::getInputValue(block, Block::Y, sprite);
+        state.glideEndX = positionXStr.isNumeric() ? positionXStr.asDouble() : state.glideStartX;
+        state.glideEndY = positionYStr.isNumeric() ? positionYStr.asDouble() : state.glideStartY;
     }
     
     auto currentTime = std::chrono::high_resolution_clock::now();
-    auto elapsedTime = std::chrono::duration_cast<std::chrono::milliseconds>(currentTime - block.waitStartTime).count();
+    auto elapsedTime = std::chrono::duration_cast<std::chrono::milliseconds>(currentTime - state.waitStartTime).count();
     
-    if (elapsedTime >= block.waitDuration) {
-        sprite->xPosition = block.glideEndX;
-        sprite->yPosition = block.glideEndY;
-        
-        block.repeatTimes = -1;
-        sprite->blockChains[block.blockChainID].blocksToRepeat.pop_back();
+    if (elapsedTime >= state.waitDuration) {
+        sprite->xPosition = state.glideEndX;
+        sprite->yPosition = state.glideEndY;
         return BlockResult::CONTINUE;
     }
     
-    double progress = static_cast<double>(elapsedTime) / block.waitDuration;
+    double progress = static_cast<double>(elapsedTime) / state.waitDuration;
     if (progress > 1.0) progress = 1.0;
     
-    sprite->xPosition = block.glideStartX + (block.glideEndX - block.glideStartX) * progress;
-    sprite->yPosition = block.glideStartY + (block.glideEndY - block.glideStartY) * progress;
+    sprite->xPosition = state.glideStartX + (state.glideEndX - state.glideStartX) * progress;
+    sprite->yPosition = state.glideStartY + (state.glideEndY - state.glideStartY) * progress;
     
     return BlockResult::RETURN;
 }
 
-BlockResult MotionBlocks::glideTo(Block& block, Sprite* sprite, Block** waitingBlock, bool* withoutScreenRefresh){
+BlockResult MotionBlocks::glideTo(Block& block, Sprite* sprite, Thread* thread){
 
-    if(block.repeatTimes == -1){
-        block.repeatTimes = -7;
+    BlockState& state = thread->state();
+    if(!state.started){
+        state.started = true;
         
-        Value duration = Scratch::getInputValue(block,"SECS", sprite);
+        Value duration = Scratch::getInputValue(block, Block::SECS, sprite);
         if(duration.isNumeric()) {
-            block.waitDuration = duration.asDouble() * 1000;
+            state.waitDuration = duration.asDouble() * 1000;
         } else {
-            block.waitDuration = 0;
+            state.waitDuration = 0;
         }
         
-        block.waitStartTime = std::chrono::high_resolution_clock::now();
-        block.glideStartX = sprite->xPosition;
-        block.glideStartY = sprite->yPosition;
+        state.waitStartTime = std::chrono::high_resolution_clock::now();
+        state.glideStartX = sprite->xPosition;
+        state.glideStartY = sprite->yPosition;
         
         Block* inputBlock;
-        auto itVal = block.parsedInputs.find("TO");
-        inputBlock = findBlock(itVal->second.literalValue.asString());
+        const ParsedInput* itVal = &block.inputs[Block::TO];
+        inputBlock = itVal->block;
         if(!inputBlock) return BlockResult::CONTINUE;
         
-        std::string inputValue = inputBlock->fields["TO"][0];
         std::string positionXStr;
         std::string positionYStr;
         
-        if(inputValue == "_random_"){
+        if(inputBlock->option == Block::TARGET_RANDOM){
             positionXStr = std::to_string(rand() % Scratch::projectWidth - Scratch::projectWidth / 2);
             positionYStr = std::to_string(rand() % Scratch::projectHeight - Scratch::projectHeight / 2);
         }
-        else if(inputValue == "_mouse_"){
+        else if(inputBlock->option == Block::TARGET_MOUSE){
             positionXStr = std::to_string(Input::mousePointer.x);
             positionYStr = std::to_string(Input::mousePointer.y);
         }
-        else{
-            for(auto & currentSprite : sprites){
-                if(currentSprite->name == inputValue){
-                    positionXStr = std::to_string(currentSprite->xPosition);
-                    positionYStr = std::to_string(currentSprite->yPosition);
-                    break;
-                }
-            }
+        else if(Sprite* target = findOriginal(inputBlock->target)){
+            positionXStr = std::to_string(target->xPosition);
+            positionYStr = std::to_string(target->yPosition);
         }
         
-        block.glideEndX = Math::isNumber(positionXStr) ? std::stod(positionXStr) : block.glideStartX;
-        block.glideEndY = Math::isNumber(positionYStr) ? std::stod(positionYStr) : block.glideStartY;
-        
-        BlockExecutor::addToRepeatQueue(sprite, const_cast<Block*>(&block));
+        if(!Math::parseNumber(positionXStr, &state.glideEndX)) state.glideEndX = state.glideStartX;
+        if(!Math::parseNumber(positionYStr, &state.glideEndY)) state.glideEndY = state.glideStartY;
     }
 
     auto currentTime = std::chrono::high_resolution_clock::now();
-    auto elapsedTime = std::chrono::duration_cast<std::chrono::milliseconds>(currentTime - block.waitStartTime).count();
+    auto elapsedTime = std::chrono::duration_cast<std::chrono::milliseconds>(currentTime - state.waitStartTime).count();
     
-    if (elapsedTime >= block.waitDuration) {
-        sprite->xPosition = block.glideEndX;
-        sprite->yPosition = block.glideEndY;
-        
-        block.repeatTimes = -1;
-        sprite->blockChains[block.blockChainID].blocksToRepeat.pop_back();
+    if (elapsedTime >= state.waitDuration) {
+        sprite->xPosition = state.glideEndX;
+        sprite->yPosition = state.glideEndY;
         return BlockResult::CONTINUE;
     }
     
-    double progress = static_cast<double>(elapsedTime) / block.waitDuration;
+    double progress = static_cast<double>(elapsedTime) / state.waitDuration;
     if (progress > 1.0) progress = 1.0;
     
-    sprite->xPosition = block.glideStartX + (block.glideEndX - block.glideStartX) * progress;
-    sprite->yPosition = block.glideStartY + (block.glideEndY - block.glideStartY) * progress;
+    sprite->xPosition = state.glideStartX + (state.glideEndX - state.glideStartX) * progress;
+    sprite->yPosition = state.glideStartY + (state.glideEndY - state.glideStartY) * progress;
     
     return BlockResult::RETURN;
 }
 
-BlockResult MotionBlocks::pointToward(Block& block, Sprite* sprite, Block** waitingBlock, bool* withoutScreenRefresh) {
-    auto itVal = block.parsedInputs.find("TOWARDS");
-    Block* inputBlock = findBlock(itVal->second.literalValue.asString());
-    if (inputBlock->fields.find("TOWARDS") == inputBlock->fields.end()) {
+BlockResult MotionBlocks::pointToward(Block& block, Sprite* sprite, Thread* thread) {
+    const ParsedInput* itVal = &block.inputs[Block::TOWARDS];
+    Block* inputBlock = itVal->block;
+    if (inputBlock == nullptr || inputBlock->field.empty()) {
         // std::cerr << "Error: Unable to find object for POINT_TOWARD block." << std::endl;
         return BlockResult::CONTINUE;
     }
     
-    std::string objectName = inputBlock->fields["TOWARDS"][0];
     double targetX = 0;
     double targetY = 0;
     
-    if (objectName == "_random_") {
+    if (inputBlock->option == Block::TARGET_RANDOM) {
         sprite->rotation = rand() % 360;
         return BlockResult::CONTINUE;
     }
     
-    if (objectName == "_mouse_") {
+    if (inputBlock->option == Block::TARGET_MOUSE) {
         targetX = Input::mousePointer.x;
         targetY = Input::mousePointer.y;
-    } else {
-        for (Sprite* currentSprite : sprites) {
-            if (currentSprite->name == objectName) {
-                targetX = currentSprite->xPosition;
-                targetY = currentSprite->yPosition;
-                break;
-            }
-        }
+    } else if (Sprite* target = findOriginal(inputBlock->target)) {
+        targetX = target->xPosition;
+        targetY = target->yPosition;
     }
     
     const double dx = targetX - sprite->xPosition;
@@ -268,18 +243,15 @@ BlockResult MotionBlocks::pointToward(Block& block, Sprite* sprite, Block** wait
     return BlockResult::CONTINUE;
 }
 
-BlockResult MotionBlocks::setRotationStyle(Block& block, Sprite* sprite, Block** waitingBlock, bool* withoutScreenRefresh) {
-    std::string value;
-    try {
-        value = block.fields.at("STYLE")[0];
-    } catch (...) {
+BlockResult MotionBlocks::setRotationStyle(Block& block, Sprite* sprite, Thread* thread) {
+    if (block.option == Block::NO_OPTION) {
         std::cerr << "unable to find rotation style." << std::endl;
         return BlockResult::CONTINUE;
     }
     
-    if (value == "left-right") {
+    if (block.option == Block::STYLE_LEFT_RIGHT) {
         sprite->rotationStyle = sprite->LEFT_RIGHT;
-    } else if (value == "don't rotate") {
+    } else if (block.option == Block::STYLE_DONT_ROTATE) {
         sprite->rotationStyle = sprite->NONE;
     } else {
         sprite->rotationStyle = sprite->ALL_AROUND;
@@ -287,7 +259,7 @@ BlockResult MotionBlocks::setRotationStyle(Block& block, Sprite* sprite, Block**
     return BlockResult::CONTINUE;
 }
 
-BlockResult MotionBlocks::ifOnEdgeBounce(Block& block, Sprite* sprite, Block** waitingBlock, bool* withoutScreenRefresh) {
+BlockResult MotionBlocks::ifOnEdgeBounce(Block& block, Sprite* sprite, Thread* thread) {
     double halfWidth = Scratch::projectWidth / 2.0;
     double halfHeight = Scratch::projectHeight / 2.0;
 
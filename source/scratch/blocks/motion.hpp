@@ -3,21 +3,21 @@
 
 class MotionBlocks{
 public:
-    static BlockResult moveSteps(Block& block, Sprite* sprite, Block** waitingBlock, bool* withoutScreenRefresh);
-    static BlockResult goToXY(Block& block, Sprite* sprite, Block** waitingBlock, bool* withoutScreenRefresh);
-    static BlockResult goTo(Block& block, Sprite* sprite, Block** waitingBlock, bool* withoutScreenRefresh);
-    static BlockResult changeXBy(Block& block, Sprite* sprite, Block** waitingBlock, bool* withoutScreenRefresh);
-    static BlockResult changeYBy(Block& block, Sprite* sprite, Block** waitingBlock, bool* withoutScreenRefresh);
-    static BlockResult setX(Block& block, Sprite* sprite, Block** waitingBlock, bool* withoutScreenRefresh);
-    static BlockResult setY(Block& block, Sprite* sprite, Block** waitingBlock, bool* withoutScreenRefresh);
-    static BlockResult glideSecsToXY(Block& block, Sprite* sprite, Block** waitingBlock, bool* withoutScreenRefresh);
-    static BlockResult glideTo(Block& block, Sprite* sprite, Block** waitingBlock, bool* withoutScreenRefresh);
-    static BlockResult turnRight(Block& block, Sprite* sprite, Block** waitingBlock, bool* withoutScreenRefresh);
-    static BlockResult turnLeft(Block& block, Sprite* sprite, Block** waitingBlock, bool* withoutScreenRefresh);
-    static BlockResult pointInDirection(Block& block, Sprite* sprite, Block** waitingBlock, bool* withoutScreenRefresh);
-    static BlockResult pointToward(Block& block, Sprite* sprite, Block** waitingBlock, bool* withoutScreenRefresh);
-    static BlockResult setRotationStyle(Block& block, Sprite* sprite, Block** waitingBlock, bool* withoutScreenRefresh);
-    static BlockResult ifOnEdgeBounce(Block& block, Sprite* sprite, Block** waitingBlock, bool* withoutScreenRefresh);
+    static BlockResult moveSteps(Block& block, Sprite* sprite, Thread* thread);
+    static BlockResult goToXY(Block& block, Sprite* sprite, Thread* thread);
+    static BlockResult goTo(Block& block, Sprite* sprite, Thread* thread);
+    static BlockResult changeXBy(Block& block, Sprite* sprite, Thread* thread);
+    static BlockResult changeYBy(Block& block, Sprite* sprite, Thread* thread);
+    static BlockResult setX(Block& block, Sprite* sprite, Thread* thread);
+    static BlockResult setY(Block& block, Sprite* sprite, Thread* thread);
+    static BlockResult glideSecsToXY(Block& block, Sprite* sprite, Thread* thread);
+    static BlockResult glideTo(Block& block, Sprite* sprite, Thread* thread);
+    static BlockResult turnRight(Block& block, Sprite* sprite, Thread* thread);
+    static BlockResult turnLeft(Block& block, Sprite* sprite, Thread* thread);
+    static BlockResult pointInDirection(Block& block, Sprite* sprite, Thread* thread);
+    static BlockResult pointToward(Block& block, Sprite* sprite, Thread* thread);
+    static BlockResult setRotationStyle(Block& block, Sprite* sprite, Thread* thread);
+    static BlockResult ifOnEdgeBounce(Block& block, Sprite* sprite, Thread* thread);
 
     static Value xPosition(Block& block,Sprite*sprite);
     static Value yPosition(Block& block,Sprite*sprite);
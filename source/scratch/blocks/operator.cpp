@@ -1,8 +1,8 @@
 #include "operator.hpp"
 
 Value OperatorBlocks::add(Block& block, Sprite* sprite) {
-    Value value1 = Scratch::getInputValue(block,"NUM1",sprite);
-    Value value2 = Scratch::getInputValue(block,"NUM2",sprite);
+    Value value1 = Scratch::getInputValue(block, Block::NUM1, sprite);
+    Value value2 = Scratch::getInputValue(block, Block::NUM2, sprite);
     if (value1.isNumeric() && value2.isNumeric()) {
         return value1 + value2;
     }
@@ -10,8 +10,8 @@ Value OperatorBlocks::add(Block& block, Sprite* sprite) {
 }
 
 Value OperatorBlocks::subtract(Block& block, Sprite* sprite) {
-    Value value1 = Scratch::getInputValue(block,"NUM1",sprite);
-    Value value2 = Scratch::getInputValue(block,"NUM2",sprite);
+    Value value1 = Scratch::getInputValue(block, Block::NUM1, sprite);
+    Value value2 = Scratch::getInputValue(block, Block::NUM2, sprite);
     if (value1.isNumeric() && value2.isNumeric()) {
         return value1 - value2;
     }
@@ -19,8 +19,8 @@ Value OperatorBlocks::subtract(Block& block, Sprite* sprite) {
 }
 
 Value OperatorBlocks::multiply(Block& block, Sprite* sprite) {
-    Value value1 = Scratch::getInputValue(block,"NUM1",sprite);
-    Value value2 = Scratch::getInputValue(block,"NUM2",sprite);
+    Value value1 = Scratch::getInputValue(block, Block::NUM1, sprite);
+    Value value2 = Scratch::getInputValue(block, Block::NUM2, sprite);
     if (value1.isNumeric() && value2.isNumeric()) {
         return value1 * value2;
     }
@@ -28,8 +28,8 @@ Value OperatorBlocks::multiply(Block& block, Sprite* sprite) {
 }
 
 Value OperatorBlocks::divide(Block& block, Sprite* sprite) {
-    Value value1 = Scratch::getInputValue(block,"NUM1",sprite);
-    Value value2 = Scratch::getInputValue(block,"NUM2",sprite);
+    Value value1 = Scratch::getInputValue(block, Block::NUM1, sprite);
+    Value value2 = Scratch::getInputValue(block, Block::NUM2, sprite);
     if (value1.isNumeric() && value2.isNumeric()) {
         return value1 / value2;
     }
@@ -37,8 +37,8 @@ Value OperatorBlocks::divide(Block& block, Sprite* sprite) {
 }
 
 Value OperatorBlocks::random(Block& block, Sprite* sprite) {
-    Value value1 = Scratch::getInputValue(block,"FROM",sprite);
-    Value value2 = Scratch::getInputValue(block,"TO",sprite);
+    Value value1 = Scratch::getInputValue(block, Block::FROM, sprite);
+    Value value2 = Scratch::getInputValue(block, Block::TO, sprite);
     if (value1.isNumeric() && value2.isNumeric()) {
         if (value1.isInteger() && value2.isInteger()) {
             int from = value1.asInt();
@@ -54,14 +54,14 @@ Value OperatorBlocks::random(Block& block, Sprite* sprite) {
 }
 
 Value OperatorBlocks::join(Block& block, Sprite* sprite) {
-    Value value1 = Scratch::getInputValue(block,"STRING1", sprite);
-    Value value2 = Scratch::getInputValue(block,"STRING2", sprite);
+    Value value1 = Scratch::getInputValue(block, Block::STRING1, sprite);
+    Value value2 = Scratch::getInputValue(block, Block::STRING2, sprite);
     return Value(value1.asString() + value2.asString());
 }
 
 Value OperatorBlocks::letterOf(Block& block, Sprite* sprite) {
-    Value value1 = Scratch::getInputValue(block,"LETTER", sprite);
-    Value value2 = Scratch::getInputValue(block,"STRING",sprite);
+    Value value1 = Scratch::getInputValue(block, Block::LETTER, sprite);
+    Value value2 = Scratch::getInputValue(block, Block::STRING, sprite);
     if (value1.isNumeric() && value2.asString() != "") {
         int index = value1.asInt() - 1;
         if (index >= 0 && index < static_cast<int>(value2.asString().size())) {
@@ -72,25 +72,27 @@ Value OperatorBlocks::letterOf(Block& block, Sprite* sprite) {
 }
 
 Value OperatorBlocks::length(Block& block, Sprite* sprite) {
-    Value value1 = Scratch::getInputValue(block,"STRING", sprite);
+    Value value1 = Scratch::getInputValue(block, Block::STRING, sprite);
     return Value(static_cast<int>(value1.asString().size()));
 }
 
 Value OperatorBlocks::mod(Block& block, Sprite* sprite) {
-    Value value1 = Scratch::getInputValue(block,"NUM1", sprite);
-    Value value2 = Scratch::getInputValue(block,"NUM2", sprite);
+    Value value1 = Scratch::getInputValue(block, Block::NUM1, sprite);
+    Value value2 = Scratch::getInputValue(block, Block::NUM2, sprite);
     if (value1.isNumeric() && value2.isNumeric()) {
-        if (floor(value1.asDouble()) == value1.asDouble() && floor(value2.asDouble()) == value2.asDouble()) {
+        double a = value1.asDouble();
+        double b = value2.asDouble();
+        if (floor(a) == a && floor(b) == b) {
             // Both are integers
-            return Value(static_cast<int>(std::fmod(value1.asDouble(), value2.asDouble())));
+            return Value(static_cast<int>(std::fmod(a, b)));
         }
-        return Value(std::fmod(value1.asDouble(), value2.asDouble()));
+        return Value(std::fmod(a, b));
     }
     return Value(0);
 }
 
 Value OperatorBlocks::round(Block& block, Sprite* sprite) {
-    Value value1 = Scratch::getInputValue(block,"NUM", sprite);
+    Value value1 = Scratch::getInputValue(block, Block::NUM, sprite);
     if (value1.isNumeric()) {
         return Value(static_cast<int>(std::round(value1.asDouble())));
     }
@@ -98,52 +100,26 @@ Value OperatorBlocks::round(Block& block, Sprite* sprite) {
 }
 
 Value OperatorBlocks::mathOp(Block& block, Sprite* sprite) {
-    Value inputValue = Scratch::getInputValue(block,"NUM", sprite);
+    Value inputValue = Scratch::getInputValue(block, Block::NUM, sprite);
     if (inputValue.isNumeric()) {
-        std::string operation = block.fields.at("OPERATOR")[0];
         double value = inputValue.asDouble();
         
-        if (operation == "abs") {
-            return Value(abs(value));
-        }
-        if (operation == "floor") {
-            return Value(static_cast<int>(floor(value)));
-        }
-        if (operation == "ceiling") {
-            return Value(static_cast<int>(ceil(value)));
-        }
-        if (operation == "sqrt") {
-            return Value(sqrt(value));
-        }
-        if (operation == "sin") {
-            return Value(sin(value * M_PI / 180.0));
-        }
-        if (operation == "cos") {
-            return Value(cos(value * M_PI / 180.0));
-        }
-        if (operation == "tan") {
-            return Value(tan(value * M_PI / 180.0));
-        }
-        if (operation == "asin") {
-            return Value(asin(value) * 180.0 / M_PI);
-        }
-        if (operation == "acos") {
-            return Value(acos(value) * 180.0 / M_PI);
-        }
-        if (operation == "atan") {
-            return Value(atan(value) * 180.0 / M_PI);
-        }
-        if (operation == "ln") {
-            return Value(log(value));
-        }
-        if (operation == "log") {
-            return Value(log10(value));
-        }
-        if (operation == "e ^") {
-            return Value(exp(value));
-        }
-        if (operation == "10 ^") {
-            return Value(pow(10, value));
+        switch (block.option) {
+            case Block::MATH_ABS: return Value(abs(value));
+            case Block::MATH_FLOOR: return Value(static_cast<int>(floor(value)));
+            case Block::MATH_CEILING: return Value(static_cast<int>(ceil(value)));
+            case Block::MATH_SQRT: return Value(sqrt(value));
+            case Block::MATH_SIN: return Value(sin(value * M_PI / 180.0));
+            case Block::MATH_COS: return Value(cos(value * M_PI / 180.0));
+            case Block::MATH_TAN: return Value(tan(value * M_PI / 180.0));
+            case Block::MATH_ASIN: return Value(asin(value) * 180.0 / M_PI);
+            case Block::MATH_ACOS: return Value(acos(value) * 180.0 / M_PI);
+            case Block::MATH_ATAN: return Value(atan(value) * 180.0 / M_PI);
+            case Block::MATH_LN: return Value(log(value));
+            case Block::MATH_LOG: return Value(log10(value));
+            case Block::MATH_E_POW: return Value(exp(value));
+            case Block::MATH_TEN_POW: return Value(pow(10, value));
+            default: break;
         }
     }
     return Value(0);
@@ -153,8 +129,8 @@ Value OperatorBlocks::equals(Block& block, Sprite* sprite){
     Value value1;
     Value value2;
     try{
-        value1 = Scratch::getInputValue(block,"OPERAND1",sprite);
-        value2 = Scratch::getInputValue(block,"OPERAND2",sprite);
+        value1 = Scratch::getInputValue(block, Block::OPERAND1, sprite);
+        value2 = Scratch::getInputValue(block, Block::OPERAND2, sprite);
     }
     catch(...){
         std::cout << "failed to get equals values." << std::endl;
@@ -171,8 +147,8 @@ Value OperatorBlocks::equals(Block& block, Sprite* sprite){
 }
 
 Value OperatorBlocks::greaterThan(Block& block, Sprite* sprite){
-    Value value1 = Scratch::getInputValue(block,"OPERAND1",sprite);
-    Value value2 = Scratch::getInputValue(block,"OPERAND2",sprite);
+    Value value1 = Scratch::getInputValue(block, Block::OPERAND1, sprite);
+    Value value2 = Scratch::getInputValue(block, Block::OPERAND2, sprite);
     if (value1.isNumeric() && value2.isNumeric()) {
         return Value(value1 > value2);
     }
@@ -180,8 +156,8 @@ Value OperatorBlocks::greaterThan(Block& block, Sprite* sprite){
 }
 
 Value OperatorBlocks::lessThan(Block& block, Sprite* sprite){
-    Value value1 = Scratch::getInputValue(block,"OPERAND1",sprite);
-    Value value2 = Scratch::getInputValue(block,"OPERAND2",sprite);
+    Value value1 = Scratch::getInputValue(block, Block::OPERAND1, sprite);
+    Value value2 = Scratch::getInputValue(block, Block::OPERAND2, sprite);
     if (value1.isNumeric() && value2.isNumeric()) {
         return Value(value1 < value2);
     }
@@ -189,48 +165,24 @@ Value OperatorBlocks::lessThan(Block& block, Sprite* sprite){
 }
 
 Value OperatorBlocks::and_(Block& block, Sprite* sprite){
-    auto oper1 = block.parsedInputs.find("OPERAND1");
-    auto oper2 = block.parsedInputs.find("OPERAND2");
-
-    if (oper1 == block.parsedInputs.end() || oper2 == block.parsedInputs.end()){
-        return Value(false);
-    }
-
-    Value value1 = executor.getBlockValue(*findBlock(oper1->second.blockId), sprite);
-    Value value2 = executor.getBlockValue(*findBlock(oper2->second.blockId), sprite);
+    Value value1 = Scratch::getInputValue(block, Block::OPERAND1, sprite);
+    Value value2 = Scratch::getInputValue(block, Block::OPERAND2, sprite);
     return Value(value1.asInt() == 1 && value2.asInt() == 1);
 }
 
 Value OperatorBlocks::or_(Block& block, Sprite* sprite) {
-    int result1 = 0;
-    int result2 = 0;
-
-    auto oper1 = block.parsedInputs.find("OPERAND1");
-    if (oper1 != block.parsedInputs.end()) {
-        Value value1 = executor.getBlockValue(*findBlock(oper1->second.blockId), sprite);
-        result1 = value1.asInt();
-    }
-
-    auto oper2 = block.parsedInputs.find("OPERAND2");
-    if (oper2 != block.parsedInputs.end()) {
-        Value value2 = executor.getBlockValue(*findBlock(oper2->second.blockId), sprite);
-        result2 = value2.asInt();
-    }
-
-    return Value(result1 == 1 || result2 == 1);
+    Value value1 = Scratch::getInputValue(block, Block::OPERAND1, sprite);
+    Value value2 = Scratch::getInputValue(block, Block::OPERAND2, sprite);
+    return Value(value1.asInt() == 1 || value2.asInt() == 1);
 }
 
 Value OperatorBlocks::not_(Block& block, Sprite* sprite){
-    auto oper = block.parsedInputs.find("OPERAND");
-    if (oper == block.parsedInputs.end()) {
-        return Value(true);
-    }
-    Value value = executor.getBlockValue(*findBlock(oper->second.blockId), sprite);
+    Value value = Scratch::getInputValue(block, Block::OPERAND, sprite);
     return Value(value.asInt() != 1);
 }
 
 Value OperatorBlocks::contains(Block& block, Sprite* sprite){
-    Value value1 = Scratch::getInputValue(block,"STRING1", sprite);
-    Value value2 = Scratch::getInputValue(block,"STRING2",sprite);
+    Value value1 = Scratch::getInputValue(block, Block::STRING1, sprite);
+    Value value2 = Scratch::getInputValue(block, Block::STRING2, sprite);
     return Value(value1.asString().find(value2.asString()) != std::string::npos);
 }
\ No newline at end of file
@@ -1,51 +1,20 @@
 #include "procedure.hpp"
 
 Value ProcedureBlocks::stringNumber(Block& block, Sprite* sprite) {
-    return findCustomValue(block.fields.at("VALUE")[0], sprite, block);
+    return findCustomValue(block.field, sprite, block);
 }
 
 Value ProcedureBlocks::booleanArgument(Block& block, Sprite* sprite){
-    Value value = findCustomValue(block.fields.at("VALUE")[0], sprite, block);
+    Value value = findCustomValue(block.field, sprite, block);
     return Value(value.asInt() == 1);
 }
 
-BlockResult ProcedureBlocks::call(Block& block, Sprite* sprite, Block** waitingBlock, bool* withoutScreenRefresh) {
-    
-    if(block.repeatTimes == -1){
-        block.repeatTimes = -8;
-        block.customBlockExecuted = false;
-        
-        // Run the custom block for the first time
-        runCustomBlock(sprite, block, &block,withoutScreenRefresh);
-        block.customBlockExecuted = true;
-        
-        BlockExecutor::addToRepeatQueue(sprite, &block);
-    }
-    
-    // Check if any repeat blocks are still running inside the custom block
-    if(block.customBlockPtr != nullptr && 
-       !BlockExecutor::hasActiveRepeats(sprite, block.customBlockPtr->blockChainID)){
-        
-        //std::cout << "done with custom!" << std::endl;
-        
-        // Custom block execution is complete
-        block.repeatTimes = -1; // Reset for next use
-        block.customBlockExecuted = false;
-        block.customBlockPtr = nullptr;
-        
-        auto chainIt = sprite->blockChains.find(block.blockChainID);
-        if (chainIt != sprite->blockChains.end() && !chainIt->second.blocksToRepeat.empty()) {
-            chainIt->second.blocksToRepeat.pop_back();
-        } else {
-            std::cerr << "Invalid or empty blockChainID: " << block.blockChainID << std::endl;
-        }
-
-        return BlockResult::CONTINUE;
-    }
-    
-    return BlockResult::RETURN;
+BlockResult ProcedureBlocks::call(Block& block, Sprite* sprite, Thread* thread) {
+    // the definition runs in its own frame, the call moves on once that frame ends
+    if(!runCustomBlock(sprite, block, thread)) return BlockResult::CONTINUE;
+    return BlockResult::BRANCH;
 }
 
-BlockResult ProcedureBlocks::definition(Block& block, Sprite* sprite, Block** waitingBlock, bool* withoutScreenRefresh) {
+BlockResult ProcedureBlocks::definition(Block& block, Sprite* sprite, Thread* thread) {
     return BlockResult::CONTINUE;
 }
\ No newline at end of file
@@ -2,27 +2,25 @@
 #include "../input.hpp"
 #include "../keyboard.hpp"
 
-BlockResult SensingBlocks::resetTimer(Block& block, Sprite* sprite, Block** waitingBlock, bool* withoutScreenRefresh) {
+BlockResult SensingBlocks::resetTimer(Block& block, Sprite* sprite, Thread* thread) {
     BlockExecutor::timer = std::chrono::high_resolution_clock::now();
     return BlockResult::CONTINUE;
 }
 
-BlockResult SensingBlocks::askAndWait(Block& block, Sprite* sprite, Block** waitingBlock, bool* withoutScreenRefresh) {
+BlockResult SensingBlocks::askAndWait(Block& block, Sprite* sprite, Thread* thread) {
     Keyboard kbd;
-    Value inputValue = Scratch::getInputValue(block,"QUESTION",sprite);
+    Value inputValue = Scratch::getInputValue(block, Block::QUESTION, sprite);
     std::string output = kbd.openKeyboard(inputValue.asString().c_str());
     answer = output;
     return BlockResult::CONTINUE;
 }
 
-BlockResult SensingBlocks::setDragMode(Block& block, Sprite* sprite, Block** waitingBlock, bool* withoutScreenRefresh){
+BlockResult SensingBlocks::setDragMode(Block& block, Sprite* sprite, Thread* thread){
 
-    std::string mode = block.fields.at("DRAG_MODE")[0];
-
-    if(mode == "draggable"){
+    if(block.option == Block::DRAGGABLE){
         sprite->draggable = true;
     }
-    else if(mode == "not draggable"){
+    else if(block.option == Block::NOT_DRAGGABLE){
         sprite->draggable = false;
     }
 
@@ -37,47 +35,33 @@ Value SensingBlocks::sensingTimer(Block& block, Sprite* sprite) {
 }
 
 Value SensingBlocks::of(Block& block, Sprite* sprite) {
-    std::string value = block.fields.at("PROPERTY")[0];
-    std::string object;
-    auto objectFind = block.parsedInputs.find("OBJECT");
-    Block* objectBlock = findBlock(objectFind->second.literalValue.asString());
+    const ParsedInput* objectFind = &block.inputs[Block::OBJECT];
+    Block* objectBlock = objectFind->block;
     if(!objectBlock || objectBlock == nullptr)
         return Value();
     
-    object = objectBlock->fields.at("OBJECT")[0];
-
-    Sprite* spriteObject = nullptr;
-    for (Sprite* currentSprite : sprites) {
-        if (currentSprite->name == object && !currentSprite->isClone) {
-            spriteObject = currentSprite;
-            break;
-        }
-    }
+    Sprite* spriteObject = findOriginal(objectBlock->target);
     
     if (!spriteObject) return Value(0);
     
-    if (value == "timer") {
-        auto now = std::chrono::high_resolution_clock::now();
-        auto elapsed = std::chrono::duration_cast<std::chrono::duration<double>>(now - BlockExecutor::timer).count();
-        return Value(elapsed);
-    } else if (value == "x position") {
-        return Value(spriteObject->xPosition);
-    } else if (value == "y position") {
-        return Value(spriteObject->yPosition);
-    } else if (value == "direction") {
-        return Value(spriteObject->rotation);
-    } else if (value == "costume #" || value == "backdrop #") {
-        return Value(spriteObject->currentCostume + 1);
-    } else if (value == "costume name" || value == "backdrop name") {
-        return Value(spriteObject->costumes[spriteObject->currentCostume].name);
-    } else if (value == "size") {
-        return Value(spriteObject->size);
-    } else if (value == "volume") {
-        return Value(spriteObject->volume);
+    switch (block.option) {
+        case Block::PROPERTY_TIMER: {
+            auto now = std::chrono::high_resolution_clock::now();
+            auto elapsed = std::chrono::duration_cast<std::chrono::duration<double>>(now - BlockExecutor::timer).count();
+            return Value(elapsed);
+        }
+        case Block::PROPERTY_X: return Value(spriteObject->xPosition);
+        case Block::PROPERTY_Y: return Value(spriteObject->yPosition);
+        case Block::PROPERTY_DIRECTION: return Value(spriteObject->rotation);
+        case Block::PROPERTY_COSTUME_NUMBER: return Value(spriteObject->currentCostume + 1);
+        case Block::PROPERTY_COSTUME_NAME: return Value(spriteObject->shared->costumes[spriteObject->currentCostume].name);
+        case Block::PROPERTY_SIZE: return Value(spriteObject->size);
+        case Block::PROPERTY_VOLUME: return Value(spriteObject->volume);
+        default: break;
     }
     
-    for (const auto& [id, variable] : spriteObject->variables) {
-        if (value == variable.name) {
+    for (const Variable& variable : spriteObject->isStage ? globals.variables : spriteObject->variables) {
+        if (block.field == variable.name) {
             return variable.value;
         }
     }
@@ -93,21 +77,17 @@ Value SensingBlocks::mouseY(Block& block, Sprite* sprite) {
 }
 
 Value SensingBlocks::distanceTo(Block& block, Sprite* sprite) {
-    auto inputFind = block.parsedInputs.find("DISTANCETOMENU");
-    Block* inputBlock = findBlock(inputFind->second.literalValue.asString());
-    std::string object = inputBlock->fields.at("DISTANCETOMENU")[0];
-    
-    if (object == "_mouse_") {
+    const ParsedInput* inputFind = &block.inputs[Block::DISTANCETOMENU];
+    Block* inputBlock = inputFind->block;
+    if (inputBlock->option == Block::TARGET_MOUSE) {
         return Value(sqrt(pow(Input::mousePointer.x - sprite->xPosition, 2) + 
                                  pow(Input::mousePointer.y - sprite->yPosition, 2)));
     }
     
-    for (Sprite* currentSprite : sprites) {
-        if (currentSprite->name == object && !currentSprite->isClone) {
-            double distance = sqrt(pow(currentSprite->xPosition - sprite->xPosition, 2) + 
-                                 pow(currentSprite->yPosition - sprite->yPosition, 2));
-            return Value(distance);
-        }
+    if (Sprite* target = findOriginal(inputBlock->target)) {
+        double distance = sqrt(pow(target->xPosition - sprite->xPosition, 2) + 
+                             pow(target->yPosition - sprite->yPosition, 2));
+        return Value(distance);
     }
     return Value(0);
 }
@@ -117,22 +97,16 @@ Value SensingBlocks::daysSince2000(Block& block, Sprite* sprite) {
 }
 
 Value SensingBlocks::current(Block& block, Sprite* sprite) {
-    std::string inputValue;
-    try {
-        inputValue = block.fields.at("CURRENTMENU")[0];
-    } catch (...) {
-        return Value();
+    switch (block.option) {
+        case Block::CURRENT_YEAR: return Value(Time::getYear());
+        case Block::CURRENT_MONTH: return Value(Time::getMonth());
+        case Block::CURRENT_DATE: return Value(Time::getDay());
+        case Block::CURRENT_DAY_OF_WEEK: return Value(Time::getDayOfWeek());
+        case Block::CURRENT_HOUR: return Value(Time::getHours());
+        case Block::CURRENT_MINUTE: return Value(Time::getMinutes());
+        case Block::CURRENT_SECOND: return Value(Time::getSeconds());
+        default: return Value();
     }
-    
-    if (inputValue == "YEAR") return Value(Time::getYear());
-    if (inputValue == "MONTH") return Value(Time::getMonth());
-    if (inputValue == "DATE") return Value(Time::getDay());
-    if (inputValue == "DAYOFWEEK") return Value(Time::getDayOfWeek());
-    if (inputValue == "HOUR") return Value(Time::getHours());
-    if (inputValue == "MINUTE") return Value(Time::getMinutes());
-    if (inputValue == "SECOND") return Value(Time::getSeconds());
-    
-    return Value();
 }
 
 Value SensingBlocks::sensingAnswer(Block& block, Sprite* sprite) {
@@ -140,30 +114,70 @@ Value SensingBlocks::sensingAnswer(Block& block, Sprite* sprite) {
 }
 
 Value SensingBlocks::keyPressed(Block& block, Sprite* sprite){
-    auto inputFind = block.parsedInputs.find("KEY_OPTION");
-    Block* inputBlock = findBlock(inputFind->second.literalValue.asString());
-    for (std::string button : Input::inputButtons) {
-        if (inputBlock->fields["KEY_OPTION"][0] == button) {
-            return Value(true);
+    const ParsedInput& input = block.inputs[Block::KEY_OPTION];
+    // the menu's key is known at load, anything else plugged in is looked up by name
+    if (input.block != nullptr && input.block->opcode == Block::SENSING_KEYOPTIONS) {
+        return Value(Input::isKeyHeld(input.block->key));
+    }
+    return Value(Input::isKeyHeld(Input::keyFromName(Scratch::getInputValue(input, sprite).asString())));
+}
+
+// the unscaled box around a sprite, for when its costume has no mask
+static Bounds spriteBox(const Sprite* sprite){
+    return {sprite->xPosition - sprite->spriteWidth / 2, sprite->xPosition + sprite->spriteWidth / 2,
+            sprite->yPosition - sprite->spriteHeight / 2, sprite->yPosition + sprite->spriteHeight / 2};
+}
+
+// whether the sprite, with its collision points already worked out, overlaps the target.
+// by pixel when both costumes have masks
+static bool isTouchingSprite(Sprite* sprite, StageMask* mask, const std::array<std::pair<double, double>, 4>& currentSpritePoints, Sprite* targetSprite){
+    // a clone deleted this tick stays in the grid until the tick ends
+    if (targetSprite == sprite || !targetSprite->visible || targetSprite->toDelete) return false;
+    StageMask* targetMask = stageMaskOf(targetSprite);
+    if (mask != nullptr && targetMask != nullptr) return masksTouch(sprite, *mask, targetSprite, *targetMask);
+    if (mask != nullptr) return maskTouchesBox(sprite, *mask, spriteBox(targetSprite));
+    if (targetMask != nullptr) return maskTouchesBox(targetSprite, *targetMask, spriteBox(sprite));
+
+    // Get collision points of the target sprite
+    auto targetSpritePoints = getCollisionPoints(targetSprite);
+
+    // Check if any point of the current sprite is inside the target sprite's bounds
+    for (const auto& point : currentSpritePoints) {
+        if (point.first >= targetSprite->xPosition - targetSprite->spriteWidth / 2 &&
+            point.first <= targetSprite->xPosition + targetSprite->spriteWidth / 2 &&
+            point.second >= targetSprite->yPosition - targetSprite->spriteHeight / 2 &&
+            point.second <= targetSprite->yPosition + targetSprite->spriteHeight / 2) {
+            return true;
         }
     }
-    return Value(false);
+
+    // Check if any point of the target sprite is inside the current sprite's bounds
+    for (const auto& point : targetSpritePoints) {
+        if (point.first >= sprite->xPosition - sprite->spriteWidth / 2 &&
+            point.first <= sprite->xPosition + sprite->spriteWidth / 2 &&
+            point.second >= sprite->yPosition - sprite->spriteHeight / 2 &&
+            point.second <= sprite->yPosition + sprite->spriteHeight / 2) {
+            return true;
+        }
+    }
+    return false;
 }
 
 Value SensingBlocks::touchingObject(Block& block, Sprite* sprite){
-    auto inputFind = block.parsedInputs.find("TOUCHINGOBJECTMENU");
-    Block* inputBlock = findBlock(inputFind->second.literalValue.asString());
-    std::string objectName;
-    try {
-        objectName = inputBlock->fields["TOUCHINGOBJECTMENU"][0];
-    } catch (...) {
-        return Value(false);
-    }
+    const ParsedInput* inputFind = &block.inputs[Block::TOUCHINGOBJECTMENU];
+    Block* inputBlock = inputFind->block;
+    if (inputBlock == nullptr) return Value(false);
 
     // Get collision points of the current sprite
-    std::vector<std::pair<double, double>> currentSpritePoints = getCollisionPoints(sprite);
-
-    if(objectName == "_mouse_") {
+    auto currentSpritePoints = getCollisionPoints(sprite);
+    StageMask* mask = stageMaskOf(sprite);
+
+    if(inputBlock->option == Block::TARGET_MOUSE) {
+        if (mask != nullptr) {
+            // just the stage pixel under the pointer
+            Bounds pointer = {(double)Input::mousePointer.x, (double)Input::mousePointer.x, (double)Input::mousePointer.y, (double)Input::mousePointer.y};
+            return Value(maskTouchesBox(sprite, *mask, pointer));
+        }
         // Check if the mouse pointer's position is within the bounds of the current sprite
         if (Input::mousePointer.x >= sprite->xPosition - sprite->spriteWidth / 2 &&
             Input::mousePointer.x <= sprite->xPosition + sprite->spriteWidth / 2 &&
@@ -174,7 +188,7 @@ Value SensingBlocks::touchingObject(Block& block, Sprite* sprite){
         return Value(false);
     }
 
-    if (objectName == "_edge_") {
+    if (inputBlock->option == Block::TARGET_EDGE) {
         double halfWidth = Scratch::projectWidth / 2.0;
         double halfHeight = Scratch::projectHeight / 2.0;
 
@@ -186,31 +200,15 @@ Value SensingBlocks::touchingObject(Block& block, Sprite* sprite){
         return Value(false);
     }
 
-    for (Sprite* targetSprite : sprites) {
-        if (targetSprite->name == objectName && targetSprite->visible) {
-            // Get collision points of the target sprite
-            std::vector<std::pair<double, double>> targetSpritePoints = getCollisionPoints(targetSprite);
-
-            // Check if any point of the current sprite is inside the target sprite's bounds
-            for (const auto& point : currentSpritePoints) {
-                if (point.first >= targetSprite->xPosition - targetSprite->spriteWidth / 2 &&
-                    point.first <= targetSprite->xPosition + targetSprite->spriteWidth / 2 &&
-                    point.second >= targetSprite->yPosition - targetSprite->spriteHeight / 2 &&
-                    point.second <= targetSprite->yPosition + targetSprite->spriteHeight / 2) {
-                    return Value(true);
-                }
-            }
-
-            // Check if any point of the target sprite is inside the current sprite's bounds
-            for (const auto& point : targetSpritePoints) {
-                if (point.first >= sprite->xPosition - sprite->spriteWidth / 2 &&
-                    point.first <= sprite->xPosition + sprite->spriteWidth / 2 &&
-                    point.second >= sprite->yPosition - sprite->spriteHeight / 2 &&
-                    point.second <= sprite->yPosition + sprite->spriteHeight / 2) {
-                    return Value(true);
-                }
-            }
-        }
+    // only the sprite and clones of it filed near this one can touch it
+    const SpriteEntry* target = findSpriteEntry(inputBlock->target);
+    if (target == nullptr) return Value(false);
+    updateMovedSprites();
+    static std::vector<Sprite*> candidates;
+    candidates.clear();
+    target->grid.query(collisionBounds(sprite), candidates);
+    for (Sprite* candidate : candidates) {
+        if (isTouchingSprite(sprite, mask, currentSpritePoints, candidate)) return Value(true);
     }
     return Value(false);
 }
@@ -36,26 +36,26 @@ Value SoundBlocks::volume(Block& block, Sprite* sprite) {
     return Value(sprite->volume);
 }
 
-BlockResult SoundBlocks::playUntilDone(Block& block, Sprite* sprite, Block** waitingBlock, bool* withoutScreenRefresh) {
+BlockResult SoundBlocks::playUntilDone(Block& block, Sprite* sprite, Thread* thread) {
     // Get sound name from SOUND_MENU input
-    Value soundMenuValue = Scratch::getInputValue(block, "SOUND_MENU", sprite);
+    Value soundMenuValue = Scratch::getInputValue(block, Block::SOUND_MENU, sprite);
     std::string soundName = soundMenuValue.asString();
     
 #ifdef __3DS__
     // Simpler approach for 3DS - just play sound and continue
     // Find the sound in the sprite's sounds
-    auto soundIt = sprite->sounds.find(soundName);
-    if (soundIt == sprite->sounds.end()) {
+    auto soundIt = sprite->shared->sounds.find(soundName);
+    if (soundIt == sprite->shared->sounds.end()) {
         // Try to find by name
-        for (const auto& [id, sound] : sprite->sounds) {
+        for (const auto& [id, sound] : sprite->shared->sounds) {
             if (sound.name == soundName) {
-                soundIt = sprite->sounds.find(id);
+                soundIt = sprite->shared->sounds.find(id);
                 break;
             }
         }
     }
     
-    if (soundIt == sprite->sounds.end()) {
+    if (soundIt == sprite->shared->sounds.end()) {
         std::cerr << "Sound not found: " << soundName << std::endl;
         return BlockResult::CONTINUE;
     }
@@ -66,22 +66,23 @@ BlockResult SoundBlocks::playUntilDone(Block& block, Sprite* sprite, Block** wai
 #else
     // PC version - full asynchronous implementation
     // First execution - start playing sound
-    if (block.repeatTimes == -1) {
-        block.repeatTimes = -10; // Use unique flag for sound playback
+    BlockState& state = thread->state();
+    if (!state.started) {
+        state.started = true;
         
         // Find the sound in the sprite's sounds
-        auto soundIt = sprite->sounds.find(soundName);
-        if (soundIt == sprite->sounds.end()) {
+        auto soundIt = sprite->shared->sounds.find(soundName);
+        if (soundIt == sprite->shared->sounds.end()) {
             // Try to find by name
-            for (const auto& [id, sound] : sprite->sounds) {
+            for (const auto& [id, sound] : sprite->shared->sounds) {
                 if (sound.name == soundName) {
-                    soundIt = sprite->sounds.find(id);
+                    soundIt = sprite->shared->sounds.find(id);
                     break;
                 }
             }
         }
         
-        if (soundIt == sprite->sounds.end()) {
+        if (soundIt == sprite->shared->sounds.end()) {
             std::cerr << "Sound not found: " << soundName << std::endl;
             return BlockResult::CONTINUE;
         }
@@ -90,36 +91,22 @@ BlockResult SoundBlocks::playUntilDone(Block& block, Sprite* sprite, Block** wai
         playSound(soundName, sprite);
         
         // Store the sound name for tracking
-        block.soundName = soundName;
-        
-        // Add to repeat queue to check completion
-        BlockExecutor::addToRepeatQueue(sprite, const_cast<Block*>(&block));
+        state.soundName = soundName;
     }
     
     // Check if sound is still playing
-    if (!block.soundName.empty() && isSoundPlaying(block.soundName)) {
+    if (!state.soundName.empty() && isSoundPlaying(state.soundName)) {
         return BlockResult::RETURN; // Keep waiting
     }
     
-    // Sound finished - clean up and continue
-    block.repeatTimes = -1;
-    
-    // Safely remove from repeat queue
-    if (!block.blockChainID.empty() && 
-        sprite->blockChains.find(block.blockChainID) != sprite->blockChains.end()) {
-        auto& repeatList = sprite->blockChains[block.blockChainID].blocksToRepeat;
-        if (!repeatList.empty()) {
-            repeatList.pop_back();
-        }
-    }
-    
+    // Sound finished - continue
     return BlockResult::CONTINUE;
 #endif
 }
 
-BlockResult SoundBlocks::play(Block& block, Sprite* sprite, Block** waitingBlock, bool* withoutScreenRefresh) {
+BlockResult SoundBlocks::play(Block& block, Sprite* sprite, Thread* thread) {
     // Get sound name from SOUND_MENU input
-    Value soundMenuValue = Scratch::getInputValue(block, "SOUND_MENU", sprite);
+    Value soundMenuValue = Scratch::getInputValue(block, Block::SOUND_MENU, sprite);
     std::string soundName = soundMenuValue.asString();
     
     playSound(soundName, sprite);
@@ -127,36 +114,36 @@ BlockResult SoundBlocks::play(Block& block, Sprite* sprite, Block** waitingBlock
     return BlockResult::CONTINUE;
 }
 
-BlockResult SoundBlocks::stopAllSounds(Block& block, Sprite* sprite, Block** waitingBlock, bool* withoutScreenRefresh) {
+BlockResult SoundBlocks::stopAllSounds(Block& block, Sprite* sprite, Thread* thread) {
     stopAllPlayingSounds();
     return BlockResult::CONTINUE;
 }
 
-BlockResult SoundBlocks::changeEffectBy(Block& block, Sprite* sprite, Block** waitingBlock, bool* withoutScreenRefresh) {
+BlockResult SoundBlocks::changeEffectBy(Block& block, Sprite* sprite, Thread* thread) {
     // TODO: Implement sound effects (pitch, pan, etc.)
     return BlockResult::CONTINUE;
 }
 
-BlockResult SoundBlocks::setEffectTo(Block& block, Sprite* sprite, Block** waitingBlock, bool* withoutScreenRefresh) {
+BlockResult SoundBlocks::setEffectTo(Block& block, Sprite* sprite, Thread* thread) {
     // TODO: Implement sound effects (pitch, pan, etc.)
     return BlockResult::CONTINUE;
 }
 
-BlockResult SoundBlocks::clearEffects(Block& block, Sprite* sprite, Block** waitingBlock, bool* withoutScreenRefresh) {
+BlockResult SoundBlocks::clearEffects(Block& block, Sprite* sprite, Thread* thread) {
     // TODO: Implement clearing sound effects
     return BlockResult::CONTINUE;
 }
 
-BlockResult SoundBlocks::changeVolumeBy(Block& block, Sprite* sprite, Block** waitingBlock, bool* withoutScreenRefresh) {
-    Value changeValue = Scratch::getInputValue(block, "VOLUME", sprite);
+BlockResult SoundBlocks::changeVolumeBy(Block& block, Sprite* sprite, Thread* thread) {
+    Value changeValue = Scratch::getInputValue(block, Block::VOLUME, sprite);
     sprite->volume += changeValue.asInt();
     if (sprite->volume < 0) sprite->volume = 0;
     if (sprite->volume > 100) sprite->volume = 100;
     return BlockResult::CONTINUE;
 }
 
-BlockResult SoundBlocks::setVolumeTo(Block& block, Sprite* sprite, Block** waitingBlock, bool* withoutScreenRefresh) {
-    Value volumeValue = Scratch::getInputValue(block, "VOLUME", sprite);
+BlockResult SoundBlocks::setVolumeTo(Block& block, Sprite* sprite, Thread* thread) {
+    Value volumeValue = Scratch::getInputValue(block, Block::VOLUME, sprite);
     sprite->volume = volumeValue.asInt();
     if (sprite->volume < 0) sprite->volume = 0;
     if (sprite->volume > 100) sprite->volume = 100;
@@ -164,15 +151,14 @@ BlockResult SoundBlocks::setVolumeTo(Block& block, Sprite* sprite, Block** waiti
 }
 
 Value SoundBlocks::soundsMenu(Block& block, Sprite* sprite) {
-    std::string soundName = block.fields["SOUND_MENU"][0].get<std::string>();
-    return Value(soundName);
+    return Value(block.field);
 }
 
 void SoundBlocks::playSound(const std::string& soundName, Sprite* sprite) {
     // Find the sound in the sprite's sounds
     Sound* soundToPlay = nullptr;
     
-    for (const auto& [id, sound] : sprite->sounds) {
+    for (const auto& [id, sound] : sprite->shared->sounds) {
         if (sound.name == soundName || id == soundName) {
             soundToPlay = const_cast<Sound*>(&sound);
             break;
@@ -5,14 +5,14 @@
 class SoundBlocks{
 public:
     static Value volume(Block& block, Sprite* sprite);
-    static BlockResult playUntilDone(Block& block, Sprite* sprite, Block** waitingBlock, bool* withoutScreenRefresh);
-    static BlockResult play(Block& block, Sprite* sprite, Block** waitingBlock, bool* withoutScreenRefresh);
-    static BlockResult stopAllSounds(Block& block, Sprite* sprite, Block** waitingBlock, bool* withoutScreenRefresh);
-    static BlockResult changeEffectBy(Block& block, Sprite* sprite, Block** waitingBlock, bool* withoutScreenRefresh);
-    static BlockResult setEffectTo(Block& block, Sprite* sprite, Block** waitingBlock, bool* withoutScreenRefresh);
-    static BlockResult clearEffects(Block& block, Sprite* sprite, Block** waitingBlock, bool* withoutScreenRefresh);
-    static BlockResult changeVolumeBy(Block& block, Sprite* sprite, Block** waitingBlock, bool* withoutScreenRefresh);
-    static BlockResult setVolumeTo(Block& block, Sprite* sprite, Block** waitingBlock, bool* withoutScreenRefresh);
+    static BlockResult playUntilDone(Block& block, Sprite* sprite, Thread* thread);
+    static BlockResult play(Block& block, Sprite* sprite, Thread* thread);
+    static BlockResult stopAllSounds(Block& block, Sprite* sprite, Thread* thread);
+    static BlockResult changeEffectBy(Block& block, Sprite* sprite, Thread* thread);
+    static BlockResult setEffectTo(Block& block, Sprite* sprite, Thread* thread);
+    static BlockResult clearEffects(Block& block, Sprite* sprite, Thread* thread);
+    static BlockResult changeVolumeBy(Block& block, Sprite* sprite, Thread* thread);
+    static BlockResult setVolumeTo(Block& block, Sprite* sprite, Thread* thread);
     static Value soundsMenu(Block& block, Sprite* sprite);
     
     // Sound loading from archives (declared in cpp file)
@@ -0,0 +1,235 @@
+#include "collisionMask.hpp"
+#include "interpret.hpp"
+#include <algorithm>
+#include <cmath>
+
+static std::unordered_map<std::string, CollisionMask> collisionMasks; // by costume id
+
+static MaskWord lowBits(int count){
+    return count >= maskWordBits ? ~MaskWord(0) : (MaskWord(1) << count) - 1;
+}
+
+// the maskWordBits bits of a row starting at any column. bits past the end of the row are 0
+static MaskWord wordAt(const MaskWord* row, int wordsPerRow, int column){
+    int word = column / maskWordBits;
+    int shift = column % maskWordBits;
+    MaskWord bits = row[word] >> shift;
+    if(shift != 0 && word + 1 < wordsPerRow) bits |= row[word + 1] << (maskWordBits - shift);
+    return bits;
+}
+
+void storeCollisionMask(const std::string& costumeId, const unsigned char* rgba, int width, int height, int pitch, float scale){
+    CollisionMask mask;
+    mask.width = width;
+    mask.height = height;
+    mask.wordsPerRow = (width + maskWordBits - 1) / maskWordBits;
+    mask.scale = scale;
+    mask.bits.assign(mask.wordsPerRow * height, 0);
+    for(int y = 0; y < height; y++){
+        const unsigned char* pixel = rgba + y * pitch;
+        MaskWord* row = &mask.bits[y * mask.wordsPerRow];
+        for(int x = 0; x < width; x++){
+            if(pixel[x * 4 + 3] != 0) row[x / maskWordBits] |= MaskWord(1) << (x % maskWordBits);
+        }
+    }
+    collisionMasks[costumeId] = std::move(mask);
+}
+
+const CollisionMask* findCollisionMask(const std::string& costumeId){
+    auto it = collisionMasks.find(costumeId);
+    return it != collisionMasks.end() ? &it->second : nullptr;
+}
+
+void clearCollisionMasks(){
+    collisionMasks.clear();
+}
+
+// the stage pixels the turned costume covers, with none of its rows sampled yet
+static void layoutStageMask(StageMask& mask, const Costume& costume){
+    const CollisionMask& source = *mask.source;
+    mask.bits.clear();
+    mask.sampledFrom = 0;
+    mask.sampledTo = 0;
+    mask.width = 0;
+    mask.height = 0;
+    mask.wordsPerRow = 0;
+    if(mask.size <= 0 || source.width == 0 || source.height == 0) return;
+
+    // image pixels per stage pixel, and where the rotation center is in the image
+    double pixelsPerUnit = source.scale * std::max(1, costume.bitmapResolution) * 100.0 / mask.size;
+    double radians = mask.angle * M_PI / 180.0;
+    double cosine = std::cos(radians);
+    double sine = std::sin(radians);
+    double flip = mask.flipped ? -1.0 : 1.0;
+    mask.centerU = costume.rotationCenterX * source.scale;
+    mask.centerV = costume.rotationCenterY * source.scale;
+    mask.stepXU = flip * pixelsPerUnit * cosine;
+    mask.stepXV = -pixelsPerUnit * sine;
+    mask.stepYU = -flip * pixelsPerUnit * sine;
+    mask.stepYV = -pixelsPerUnit * cosine;
+
+    // stage bounds of the image's corners, turned clockwise by the angle
+    double minX = INFINITY, maxX = -INFINITY, minY = INFINITY, maxY = -INFINITY;
+    for(int corner = 0; corner < 4; corner++){
+        double unturnedX = flip * ((corner & 1 ? source.width : 0) - mask.centerU) / pixelsPerUnit;
+        double unturnedY = -((corner & 2 ? source.height : 0) - mask.centerV) / pixelsPerUnit;
+        double x = unturnedX * cosine + unturnedY * sine;
+        double y = -unturnedX * sine + unturnedY * cosine;
+        minX = std::min(minX, x);
+        maxX = std::max(maxX, x);
+        minY = std::min(minY, y);
+        maxY = std::max(maxY, y);
+    }
+    mask.left = static_cast<int>(std::floor(minX));
+    mask.top = static_cast<int>(std::ceil(maxY));
+    mask.width = static_cast<int>(std::ceil(maxX)) - mask.left + 1;
+    mask.height = mask.top - static_cast<int>(std::floor(minY)) + 1;
+    mask.wordsPerRow = (mask.width + maskWordBits - 1) / maskWordBits;
+    mask.bits.assign(mask.wordsPerRow * mask.height, 0);
+}
+
+// narrows [first, last) to the columns where start + step * column is within [0, size)
+static void columnsInside(double start, double step, int size, double& first, double& last){
+    if(step == 0){
+        if(start < 0 || start >= size) last = first;
+        return;
+    }
+    double from = -start / step;
+    double to = (size - start) / step;
+    first = std::max(first, std::min(from, to));
+    last = std::min(last, std::max(from, to));
+}
+
+// samples the costume mask at the stage pixels of rows [firstRow, lastRow)
+static void sampleRows(StageMask& mask, int firstRow, int lastRow){
+    const CollisionMask& source = *mask.source;
+    for(int row = firstRow; row < lastRow; row++){
+        double y = mask.top - row;
+        double u = mask.centerU + mask.stepXU * mask.left + mask.stepYU * y;
+        double v = mask.centerV + mask.stepXV * mask.left + mask.stepYV * y;
+        // only the columns that land on the image
+        double first = 0, last = mask.width;
+        columnsInside(u, mask.stepXU, source.width, first, last);
+        columnsInside(v, mask.stepXV, source.height, first, last);
+        int firstColumn = std::max(0, static_cast<int>(std::floor(first)));
+        int lastColumn = std::min(mask.width, static_cast<int>(std::ceil(last)) + 1);
+        u += mask.stepXU * firstColumn;
+        v += mask.stepXV * firstColumn;
+        MaskWord* bits = &mask.bits[row * mask.wordsPerRow];
+        for(int column = firstColumn; column < lastColumn; column++, u += mask.stepXU, v += mask.stepXV){
+            if(u < 0 || v < 0 || u >= source.width || v >= source.height) continue;
+            if(source.isSet(static_cast<int>(u), static_cast<int>(v))) bits[column / maskWordBits] |= MaskWord(1) << (column % maskWordBits);
+        }
+    }
+}
+
+// makes sure rows [firstRow, lastRow) are sampled. the sampled rows stay one range, so a gap gets sampled too
+static void sampleRowsOf(StageMask& mask, int firstRow, int lastRow){
+    if(mask.sampledFrom < mask.sampledTo && firstRow >= mask.sampledFrom && lastRow <= mask.sampledTo) return;
+    if(mask.sampledFrom == mask.sampledTo){
+        sampleRows(mask, firstRow, lastRow);
+        mask.sampledFrom = firstRow;
+        mask.sampledTo = lastRow;
+        return;
+    }
+    if(firstRow < mask.sampledFrom) sampleRows(mask, firstRow, mask.sampledFrom);
+    if(lastRow > mask.sampledTo) sampleRows(mask, mask.sampledTo, lastRow);
+    mask.sampledFrom = std::min(mask.sampledFrom, firstRow);
+    mask.sampledTo = std::max(mask.sampledTo, lastRow);
+}
+
+StageMask* stageMaskOf(Sprite* sprite){
+    if(sprite->currentCostume < 0 || sprite->currentCostume >= static_cast<int>(sprite->shared->costumes.size())) return nullptr;
+    StageMask& mask = sprite->stageMask;
+    const Costume& costume = sprite->shared->costumes[sprite->currentCostume];
+    double angle = sprite->rotationStyle == Sprite::ALL_AROUND ? sprite->rotation - 90 : 0;
+    bool flipped = sprite->rotationStyle == Sprite::LEFT_RIGHT && sprite->rotation < 0;
+
+    bool changed = mask.size != sprite->size || mask.angle != angle || mask.flipped != flipped;
+    if(mask.costume != sprite->currentCostume || mask.source == nullptr){
+        // only look the costume up again once a new mask could have been stored for it
+        if(mask.costume == sprite->currentCostume && mask.masksSeen == collisionMasks.size()) return nullptr;
+        mask.costume = sprite->currentCostume;
+        mask.source = findCollisionMask(costume.id);
+        mask.masksSeen = collisionMasks.size();
+        if(mask.source == nullptr) return nullptr;
+        changed = true;
+    }
+    if(changed){
+        mask.size = sprite->size;
+        mask.angle = angle;
+        mask.flipped = flipped;
+        layoutStageMask(mask, costume);
+    }
+    return &mask;
+}
+
+Bounds stageMaskBounds(const Sprite* sprite, const StageMask& mask){
+    double left = std::lround(sprite->xPosition) + mask.left;
+    double top = std::lround(sprite->yPosition) + mask.top;
+    return {left, left + mask.width - 1, top - mask.height + 1, top};
+}
+
+// like scratch, only pixels on the stage count
+static Bounds clipToStage(Bounds bounds){
+    bounds.left = std::max(bounds.left, -Scratch::projectWidth / 2.0);
+    bounds.right = std::min(bounds.right, Scratch::projectWidth / 2.0);
+    bounds.bottom = std::max(bounds.bottom, -Scratch::projectHeight / 2.0);
+    bounds.top = std::min(bounds.top, Scratch::projectHeight / 2.0);
+    return bounds;
+}
+
+bool masksTouch(const Sprite* a, StageMask& maskA, const Sprite* b, StageMask& maskB){
+    if(maskA.width == 0 || maskB.width == 0) return false;
+    Bounds boundsA = stageMaskBounds(a, maskA);
+    Bounds boundsB = stageMaskBounds(b, maskB);
+    Bounds overlap = clipToStage({std::max(boundsA.left, boundsB.left), std::min(boundsA.right, boundsB.right),
+                                  std::max(boundsA.bottom, boundsB.bottom), std::min(boundsA.top, boundsB.top)});
+    int left = static_cast<int>(std::ceil(overlap.left));
+    int right = static_cast<int>(std::floor(overlap.right));
+    int bottom = static_cast<int>(std::ceil(overlap.bottom));
+    int top = static_cast<int>(std::floor(overlap.top));
+    if(left > right || bottom > top) return false;
+
+    int columnA = left - static_cast<int>(boundsA.left);
+    int columnB = left - static_cast<int>(boundsB.left);
+    int columns = right - left + 1;
+    // rows are sampled as they're reached, so finding a hit early skips sampling the rest
+    for(int y = top; y >= bottom; y--){
+        int indexA = static_cast<int>(boundsA.top) - y;
+        int indexB = static_cast<int>(boundsB.top) - y;
+        sampleRowsOf(maskA, indexA, indexA + 1);
+        sampleRowsOf(maskB, indexB, indexB + 1);
+        const MaskWord* rowA = &maskA.bits[indexA * maskA.wordsPerRow];
+        const MaskWord* rowB = &maskB.bits[indexB * maskB.wordsPerRow];
+        for(int column = 0; column < columns; column += maskWordBits){
+            MaskWord both = wordAt(rowA, maskA.wordsPerRow, columnA + column) & wordAt(rowB, maskB.wordsPerRow, columnB + column);
+            if(both & lowBits(columns - column)) return true;
+        }
+    }
+    return false;
+}
+
+bool maskTouchesBox(const Sprite* sprite, StageMask& mask, const Bounds& box){
+    if(mask.width == 0) return false;
+    Bounds bounds = stageMaskBounds(sprite, mask);
+    Bounds overlap = clipToStage({std::max(bounds.left, box.left), std::min(bounds.right, box.right),
+                                  std::max(bounds.bottom, box.bottom), std::min(bounds.top, box.top)});
+    int left = static_cast<int>(std::ceil(overlap.left));
+    int right = static_cast<int>(std::floor(overlap.right));
+    int bottom = static_cast<int>(std::ceil(overlap.bottom));
+    int top = static_cast<int>(std::floor(overlap.top));
+    if(left > right || bottom > top) return false;
+
+    int firstColumn = left - static_cast<int>(bounds.left);
+    int columns = right - left + 1;
+    for(int y = top; y >= bottom; y--){
+        int index = static_cast<int>(bounds.top) - y;
+        sampleRowsOf(mask, index, index + 1);
+        const MaskWord* row = &mask.bits[index * mask.wordsPerRow];
+        for(int column = 0; column < columns; column += maskWordBits){
+            if(wordAt(row, mask.wordsPerRow, firstColumn + column) & lowBits(columns - column)) return true;
+        }
+    }
+    return false;
+}
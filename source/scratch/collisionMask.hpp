@@ -0,0 +1,75 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class Sprite;
+struct Bounds;
+
+// masks are rows of register sized words, so comparing two rows is one AND per word on pc and 3ds alike
+using MaskWord = std::uintptr_t;
+constexpr int maskWordBits = sizeof(MaskWord) * 8;
+
+// a costume's alpha, one bit per pixel (set where it isn't fully transparent). made when the image is decoded
+struct CollisionMask {
+    int width = 0;
+    int height = 0;
+    int wordsPerRow = 0;
+    float scale = 1.0f; // image pixels per costume pixel, svgs can be rasterized bigger or smaller
+    std::vector<MaskWord> bits; // rows from the top, bit i of a word is column i
+
+    bool isSet(int x, int y) const {
+        return (bits[y * wordsPerRow + x / maskWordBits] >> (x % maskWordBits)) & 1;
+    }
+};
+
+// a sprite's costume mask turned, flipped and scaled onto the stage's pixels, relative to its rounded position.
+// kept on the sprite and only made again when its costume, size or direction changes. rows are only
+// sampled once a touching check reaches them, so a sprite turning every frame doesn't sample rows nothing looks at
+struct StageMask {
+    // copying a sprite, like when it's cloned, doesn't copy its mask. the copy makes its own when it's first checked
+    StageMask() = default;
+    StageMask(const StageMask&) {}
+    StageMask(StageMask&&) = default;
+    StageMask& operator=(const StageMask&) {
+        return *this = StageMask();
+    }
+    StageMask& operator=(StageMask&&) = default;
+
+    const CollisionMask* source = nullptr;
+    int costume = -1;
+    int size = 0;
+    double angle = 0;
+    bool flipped = false;
+    unsigned int masksSeen = 0; // how many masks there were when there wasn't one for the costume
+
+    int left = 0; // stage x of the first column
+    int top = 0; // stage y of the first row
+    int width = 0;
+    int height = 0;
+    int wordsPerRow = 0;
+    int sampledFrom = 0; // rows [sampledFrom, sampledTo) have been sampled
+    int sampledTo = 0;
+    // the image pixel under stage pixel (x, y) is (centerU + x * stepXU + y * stepYU, centerV + x * stepXV + y * stepYV)
+    double centerU = 0;
+    double centerV = 0;
+    double stepXU = 0;
+    double stepXV = 0;
+    double stepYU = 0;
+    double stepYV = 0;
+    std::vector<MaskWord> bits;
+};
+
+// rgba rows are pitch bytes apart
+void storeCollisionMask(const std::string& costumeId, const unsigned char* rgba, int width, int height, int pitch, float scale = 1.0f);
+const CollisionMask* findCollisionMask(const std::string& costumeId);
+// drops every stored mask, for when the project's images and sprites are torn down
+void clearCollisionMasks();
+
+// nullptr while the sprite's costume has no mask, like when its image isn't loaded
+StageMask* stageMaskOf(Sprite* sprite);
+Bounds stageMaskBounds(const Sprite* sprite, const StageMask& mask);
+// whether a solid pixel of one sprite is on a solid pixel of the other
+bool masksTouch(const Sprite* a, StageMask& maskA, const Sprite* b, StageMask& maskB);
+// whether a solid pixel of the sprite is inside the box
+bool maskTouchesBox(const Sprite* sprite, StageMask& mask, const Bounds& box);
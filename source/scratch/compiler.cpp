@@ -0,0 +1,303 @@
+#include "compiler.hpp"
+#include "interpret.hpp"
+
+static Block* lookupBlock(Sprite* sprite, const std::string& blockId){
+    if(blockId.empty()) return nullptr;
+    auto it = sprite->shared->blocks.find(blockId);
+    return it != sprite->shared->blocks.end() ? &it->second : nullptr;
+}
+
+static void linkInput(Sprite* sprite, ParsedInput& input){
+    if(input.inputType == ParsedInput::VARIABLE){
+        input.variable = resolveVariable(input.variableId, sprite);
+        if(input.variable.scope == VariableRef::UNRESOLVED) input.list = resolveList(input.variableId, sprite);
+    }
+    else if(input.inputType == ParsedInput::LITERAL){
+        // menus are stored as a literal holding the shadow block's id
+        input.block = input.literalValue.isString() ? lookupBlock(sprite, input.literalValue.asString()) : nullptr;
+    }
+    else input.block = lookupBlock(sprite, input.blockId);
+}
+
+struct OptionName {
+    const char* name;
+    Block::FieldOption option;
+};
+
+static const OptionName stopOptions[] = {
+    {"all", Block::STOP_ALL}, {"this script", Block::STOP_THIS_SCRIPT}, {"other scripts in sprite", Block::STOP_OTHER_SCRIPTS},
+    {"other scripts in stage", Block::STOP_OTHER_SCRIPTS},
+};
+static const OptionName mathOptions[] = {
+    {"abs", Block::MATH_ABS}, {"floor", Block::MATH_FLOOR}, {"ceiling", Block::MATH_CEILING}, {"sqrt", Block::MATH_SQRT},
+    {"sin", Block::MATH_SIN}, {"cos", Block::MATH_COS}, {"tan", Block::MATH_TAN}, {"asin", Block::MATH_ASIN},
+    {"acos", Block::MATH_ACOS}, {"atan", Block::MATH_ATAN}, {"ln", Block::MATH_LN}, {"log", Block::MATH_LOG},
+    {"e ^", Block::MATH_E_POW}, {"10 ^", Block::MATH_TEN_POW},
+};
+static const OptionName layerOptions[] = {
+    {"forward", Block::LAYER_FORWARD}, {"backward", Block::LAYER_BACKWARD}, {"front", Block::LAYER_FRONT}, {"back", Block::LAYER_BACK},
+};
+static const OptionName effectOptions[] = {
+    {"COLOR", Block::EFFECT_COLOR}, {"FISHEYE", Block::EFFECT_FISHEYE}, {"WHIRL", Block::EFFECT_WHIRL}, {"PIXELATE", Block::EFFECT_PIXELATE},
+    {"MOSAIC", Block::EFFECT_MOSAIC}, {"BRIGHTNESS", Block::EFFECT_BRIGHTNESS}, {"GHOST", Block::EFFECT_GHOST},
+};
+static const OptionName numberNameOptions[] = {
+    {"number", Block::NUMBER}, {"name", Block::NAME},
+};
+static const OptionName dragModeOptions[] = {
+    {"draggable", Block::DRAGGABLE}, {"not draggable", Block::NOT_DRAGGABLE},
+};
+static const OptionName styleOptions[] = {
+    {"left-right", Block::STYLE_LEFT_RIGHT}, {"don't rotate", Block::STYLE_DONT_ROTATE}, {"all around", Block::STYLE_ALL_AROUND},
+};
+static const OptionName currentOptions[] = {
+    {"YEAR", Block::CURRENT_YEAR}, {"MONTH", Block::CURRENT_MONTH}, {"DATE", Block::CURRENT_DATE}, {"DAYOFWEEK", Block::CURRENT_DAY_OF_WEEK},
+    {"HOUR", Block::CURRENT_HOUR}, {"MINUTE", Block::CURRENT_MINUTE}, {"SECOND", Block::CURRENT_SECOND},
+};
+static const OptionName propertyOptions[] = {
+    {"x position", Block::PROPERTY_X}, {"y position", Block::PROPERTY_Y}, {"direction", Block::PROPERTY_DIRECTION},
+    {"costume #", Block::PROPERTY_COSTUME_NUMBER}, {"backdrop #", Block::PROPERTY_COSTUME_NUMBER},
+    {"costume name", Block::PROPERTY_COSTUME_NAME}, {"backdrop name", Block::PROPERTY_COSTUME_NAME},
+    {"size", Block::PROPERTY_SIZE}, {"volume", Block::PROPERTY_VOLUME}, {"timer", Block::PROPERTY_TIMER},
+};
+static const OptionName targetOptions[] = {
+    {"_random_", Block::TARGET_RANDOM}, {"_mouse_", Block::TARGET_MOUSE}, {"_edge_", Block::TARGET_EDGE}, {"_myself_", Block::TARGET_MYSELF},
+};
+
+template<size_t N>
+static Block::FieldOption findOption(const OptionName (&options)[N], const std::string& name){
+    for(const OptionName& option : options){
+        if(name == option.name) return option.option;
+    }
+    return Block::NO_OPTION;
+}
+
+// the choice a field stands for, if the block's field is one with a fixed set of them
+static Block::FieldOption decodeOption(const Block& block){
+    switch(block.opcode){
+        case Block::CONTROL_STOP: return findOption(stopOptions, block.field);
+        case Block::OPERATOR_MATHOP: return findOption(mathOptions, block.field);
+        case Block::LOOKS_GO_FORWARD_BACKWARD_LAYERS:
+        case Block::LOOKS_GO_TO_FRONT_BACK: return findOption(layerOptions, block.field);
+        case Block::LOOKS_SET_EFFECT_TO:
+        case Block::LOOKS_CHANGE_EFFECT_BY: return findOption(effectOptions, block.field);
+        case Block::LOOKS_COSTUMENUMBERNAME:
+        case Block::LOOKS_BACKDROPNUMBERNAME: return findOption(numberNameOptions, block.field);
+        case Block::SENSING_SET_DRAG_MODE: return findOption(dragModeOptions, block.field);
+        case Block::MOTION_SET_ROTATION_STYLE: return findOption(styleOptions, block.field);
+        case Block::SENSING_CURRENT: return findOption(currentOptions, block.field);
+        case Block::SENSING_OF: return findOption(propertyOptions, block.field);
+        case Block::MOTION_GOTO_MENU:
+        case Block::MOTION_GLIDE_TO_MENU:
+        case Block::MOTION_POINT_TOWARD_MENU:
+        case Block::SENSING_DISTANCETO_MENU:
+        case Block::SENSING_TOUCHINGOBJECTMENU:
+        case Block::CONTROL_CREATE_CLONE_OF_MENU: return findOption(targetOptions, block.field);
+        default: return Block::NO_OPTION;
+    }
+}
+
+// the sprite an object menu names, as an interned sprite name
+static int findTarget(const Block& block){
+    switch(block.opcode){
+        case Block::MOTION_GOTO_MENU:
+        case Block::MOTION_GLIDE_TO_MENU:
+        case Block::MOTION_POINT_TOWARD_MENU:
+        case Block::SENSING_DISTANCETO_MENU:
+        case Block::SENSING_TOUCHINGOBJECTMENU:
+            return findSpriteId(block.field);
+        case Block::CONTROL_CREATE_CLONE_OF_MENU:
+            return findSpriteId(removeQuotations(block.field));
+        case Block::SENSING_OF_OBJECT_MENU:
+            if(block.field == "_stage_") return Scratch::stage != nullptr ? Scratch::stage->nameId : -1;
+            return findSpriteId(block.field);
+        default:
+            return -1;
+    }
+}
+
+void linkSprite(Sprite* sprite){
+    sprite->shared->broadcastHats.clear();
+    sprite->shared->flagHats.clear();
+    sprite->shared->cloneHats.clear();
+    sprite->shared->keyHats.clear();
+    for(auto& [id, block] : sprite->shared->blocks){
+        block.nextBlock = lookupBlock(sprite, block.next);
+        block.parentBlock = lookupBlock(sprite, block.parent);
+        block.topLevelParentBlock = nullptr;
+        for(ParsedInput& input : block.inputs) linkInput(sprite, input);
+        for(ParsedInput& input : block.arguments) linkInput(sprite, input);
+        // variable and list ids are unique across both, same as for inputs
+        if(!block.fieldId.empty()){
+            block.variable = resolveVariable(block.fieldId, sprite);
+            if(block.variable.scope == VariableRef::UNRESOLVED) block.list = resolveList(block.fieldId, sprite);
+            std::string().swap(block.fieldId);
+        }
+        if(block.opcode == Block::PROCEDURES_CALL && !block.proccode.empty()){
+            auto custom = sprite->shared->customBlocks.find(block.proccode);
+            block.procedure = custom != sprite->shared->customBlocks.end() ? &custom->second : nullptr;
+            std::string().swap(block.proccode);
+        }
+        block.option = decodeOption(block);
+        if(block.option == Block::NO_OPTION) block.target = findTarget(block);
+        if(block.opcode == Block::EVENT_WHEN_KEY_PRESSED || block.opcode == Block::SENSING_KEYOPTIONS) block.key = Input::keyFromName(block.field);
+        if(block.opcode == Block::EVENT_WHENBROADCASTRECEIVED){
+            block.broadcast = internBroadcast(block.field);
+            sprite->shared->broadcastHats.push_back(&block);
+        }
+        else if(block.opcode == Block::EVENT_WHENFLAGCLICKED) sprite->shared->flagHats.push_back(&block);
+        else if(block.opcode == Block::CONTROL_START_AS_CLONE) sprite->shared->cloneHats.push_back(&block);
+        else if(block.opcode == Block::EVENT_WHEN_KEY_PRESSED && block.key != Input::Key::NONE) sprite->shared->keyHats.push_back(&block);
+    }
+
+    // walk up to the first block that already knows its top level block, then fill the path in.
+    // every block is written once, so this stays linear
+    std::vector<Block*> path;
+    for(auto& [id, block] : sprite->shared->blocks){
+        Block* current = &block;
+        while(current->topLevelParentBlock == nullptr && current->parentBlock != nullptr){
+            path.push_back(current);
+            current = current->parentBlock;
+        }
+        Block* topLevel = current->topLevelParentBlock ? current->topLevelParentBlock : current;
+        current->topLevelParentBlock = topLevel;
+        for(Block* pathBlock : path) pathBlock->topLevelParentBlock = topLevel;
+        path.clear();
+    }
+}
+
+// operators whose value only depends on their inputs. random is left out on purpose
+static bool isPureReporter(Block::opCode opcode){
+    switch(opcode){
+        case Block::OPERATOR_ADD:
+        case Block::OPERATOR_SUBTRACT:
+        case Block::OPERATOR_MULTIPLY:
+        case Block::OPERATOR_DIVIDE:
+        case Block::OPERATOR_JOIN:
+        case Block::OPERATOR_LETTER_OF:
+        case Block::OPERATOR_LENGTH:
+        case Block::OPERATOR_MOD:
+        case Block::OPERATOR_ROUND:
+        case Block::OPERATOR_MATHOP:
+        case Block::OPERATOR_EQUALS:
+        case Block::OPERATOR_GT:
+        case Block::OPERATOR_LT:
+        case Block::OPERATOR_AND:
+        case Block::OPERATOR_OR:
+        case Block::OPERATOR_NOT:
+        case Block::OPERATOR_CONTAINS:
+            return true;
+        default:
+            return false;
+    }
+}
+
+static bool isConstant(Block* block, std::unordered_map<Block*, bool>& known){
+    auto it = known.find(block);
+    if(it != known.end()) return it->second;
+
+    bool constant = isPureReporter(block->opcode);
+    for(const ParsedInput& input : block->inputs){
+        if(!constant) break;
+        if(input.inputType == ParsedInput::VARIABLE) constant = false;
+        else if(input.block != nullptr && input.inputType != ParsedInput::LITERAL) constant = isConstant(input.block, known);
+        else if(input.block != nullptr) constant = false; // a menu
+    }
+    known[block] = constant;
+    return constant;
+}
+
+// the blocks in a constant subtree, all of which go away when it's folded
+static int countBlocks(const Block* block){
+    int count = 1;
+    for(const ParsedInput& input : block->inputs){
+        if(input.block != nullptr && input.inputType != ParsedInput::LITERAL) count += countBlocks(input.block);
+    }
+    return count;
+}
+
+static int foldInput(Sprite* sprite, ParsedInput& input, std::unordered_map<Block*, bool>& known){
+    if(input.inputType == ParsedInput::LITERAL || input.inputType == ParsedInput::VARIABLE) return 0;
+    if(input.block == nullptr || !isConstant(input.block, known)) return 0;
+
+    int folded = countBlocks(input.block);
+    input.literalValue = executor.getBlockValue(*input.block, sprite);
+    input.inputType = ParsedInput::LITERAL;
+    input.block = nullptr;
+    input.blockId.clear();
+    return folded;
+}
+
+int foldConstants(Sprite* sprite){
+    std::unordered_map<Block*, bool> known;
+    int folded = 0;
+    for(auto& [id, block] : sprite->shared->blocks){
+        // a constant block is folded along with the block using it, so only the largest subtrees are
+        if(isConstant(&block, known)) continue;
+        for(ParsedInput& input : block.inputs) folded += foldInput(sprite, input, known);
+        for(ParsedInput& input : block.arguments) folded += foldInput(sprite, input, known);
+    }
+    return folded;
+}
+
+static int compileChain(Sprite* sprite, Block* block);
+
+// SUBSTACK and SUBSTACK2 share their slots with other inputs (NUM2, SECS...), so only
+// the C blocks have substacks to compile
+static bool hasSubstacks(Block::opCode opcode){
+    switch(opcode){
+        case Block::CONTROL_IF:
+        case Block::CONTROL_IF_ELSE:
+        case Block::CONTROL_REPEAT:
+        case Block::CONTROL_REPEAT_UNTIL:
+        case Block::CONTROL_FOREVER:
+        case Block::CONTROL_WHILE:
+            return true;
+        default:
+            return false;
+    }
+}
+
+static int compileSubstack(Sprite* sprite, Block& block, int slot){
+    if(!hasSubstacks(block.opcode)) return -1;
+    Block* substackBlock = block.inputs[slot].block;
+    if(substackBlock == nullptr) return -1;
+    return compileChain(sprite, substackBlock);
+}
+
+// lays the chain out depth first, so a C block is directly followed by its substack.
+static int compileChain(Sprite* sprite, Block* block){
+    int first = -1;
+    int previous = -1;
+
+    while(block != nullptr){
+        int index = sprite->shared->program.size();
+        Instruction instruction;
+        instruction.opcode = block->opcode;
+        instruction.block = block;
+        sprite->shared->program.push_back(instruction);
+        block->pc = index;
+
+        if(previous == -1) first = index;
+        else sprite->shared->program[previous].next = index;
+
+        // (don't hold a reference to the instruction, compiling the substack grows the program)
+        int substack = compileSubstack(sprite, *block, Block::SUBSTACK);
+        sprite->shared->program[index].substack = substack;
+        int substack2 = compileSubstack(sprite, *block, Block::SUBSTACK2);
+        sprite->shared->program[index].substack2 = substack2;
+
+        previous = index;
+        block = block->nextBlock;
+    }
+    return first;
+}
+
+void compileSprite(Sprite* sprite){
+    sprite->shared->program.clear();
+    sprite->shared->program.reserve(sprite->shared->blocks.size());
+    for(auto& [id, block] : sprite->shared->blocks){
+        if(!block.topLevel) continue;
+        compileChain(sprite, &block);
+    }
+}
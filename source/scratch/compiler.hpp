@@ -0,0 +1,11 @@
+#pragma once
+#include "sprite.hpp"
+
+// resolves next/parent/input block ids of the sprite into pointers, one pass over its blocks
+void linkSprite(Sprite* sprite);
+
+// replaces operator subtrees with only literal inputs by their value. returns how many blocks were folded
+int foldConstants(Sprite* sprite);
+
+// lowers every script of the sprite into its flat instruction array
+void compileSprite(Sprite* sprite);
@@ -0,0 +1,53 @@
+#include "framePacer.hpp"
+#include <cmath>
+#include <thread>
+
+// sleeping can overshoot by a scheduler tick, so the last bit before a deadline is spun instead
+static const std::chrono::microseconds spinTime(1500);
+static const std::chrono::seconds reportInterval(5);
+
+static double toMilliseconds(std::chrono::steady_clock::duration duration){
+    return std::chrono::duration<double, std::milli>(duration).count();
+}
+
+void FramePacer::start(int fps){
+    if(fps <= 0) fps = 30;
+    period = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / fps));
+    nextFrame = Clock::now();
+    lastFrame = nextFrame;
+    reportStart = nextFrame;
+    frames = 0;
+    jitterTotal = 0;
+    overshootTotal = 0;
+}
+
+void FramePacer::waitForNextFrame(){
+    Clock::time_point now = Clock::now();
+    if(nextFrame - now > spinTime){
+        std::this_thread::sleep_until(nextFrame - spinTime);
+    }
+    while((now = Clock::now()) < nextFrame){}
+
+    frames++;
+    overshootTotal += toMilliseconds(now - nextFrame);
+    double length = toMilliseconds(now - lastFrame);
+    jitterTotal += std::abs(length - toMilliseconds(period));
+    lastFrame = now;
+
+    // a frame that ran long doesn't make the ones after it rush to catch up
+    nextFrame += period;
+    if(nextFrame <= now) nextFrame = now + period;
+
+    if(now - reportStart >= reportInterval) report(now);
+}
+
+void FramePacer::report(Clock::time_point now){
+    fps = frames / std::chrono::duration<double>(now - reportStart).count();
+    jitter = jitterTotal / frames;
+    overshoot = overshootTotal / frames;
+
+    reportStart = now;
+    frames = 0;
+    jitterTotal = 0;
+    overshootTotal = 0;
+}
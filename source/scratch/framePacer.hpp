@@ -0,0 +1,37 @@
+#pragma once
+#include <chrono>
+
+// keeps the main loop at a steady framerate by sleeping until each frame is due,
+// instead of polling the clock in a loop. uses steady_clock, sleeps need a clock that can't jump
+class FramePacer {
+public:
+    void start(int fps);
+
+    // sleeps until the next frame is due, spinning only for the last moment since sleeps
+    // tend to wake up late. returns right away when the loop is already behind
+    void waitForNextFrame();
+
+    // averages over the last few seconds, nothing is printed. 0 until the first ones are in
+    double getFPS() const { return fps; }
+    double getJitter() const { return jitter; } // average ms a frame's length was off the target
+    double getOvershoot() const { return overshoot; } // average ms a frame started after it was due
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    void report(Clock::time_point now);
+
+    Clock::duration period;
+    Clock::time_point nextFrame;
+    Clock::time_point lastFrame;
+
+    // running totals since the last report
+    Clock::time_point reportStart;
+    int frames = 0;
+    double jitterTotal = 0;
+    double overshootTotal = 0;
+
+    double fps = 0;
+    double jitter = 0;
+    double overshoot = 0;
+};
@@ -1,5 +1,5 @@
 #pragma once
-#include <vector>
+#include <bitset>
 #include <string>
 
 class Input{
@@ -12,9 +12,28 @@ public:
     };
     static Mouse mousePointer;
 
+    // the keys scratch's key menus offer. KEY_OPTION fields are resolved to these at load
+    enum class Key : unsigned char {
+        SPACE, UP_ARROW, DOWN_ARROW, LEFT_ARROW, RIGHT_ARROW, ANY,
+        A, B, C, D, E, F, G, H, I, J, K, L, M, N, O, P, Q, R, S, T, U, V, W, X, Y, Z,
+        DIGIT_0, DIGIT_1, DIGIT_2, DIGIT_3, DIGIT_4, DIGIT_5, DIGIT_6, DIGIT_7, DIGIT_8, DIGIT_9,
+        COUNT,
+        NONE = COUNT
+    };
+    static constexpr int keyCount = static_cast<int>(Key::COUNT);
+    using KeySet = std::bitset<keyCount>;
+
+    static KeySet keysHeld;
+    static KeySet keysPressed; // went down this frame
+
+    // called by getInput with the keys held this frame, works out which ones were just pressed
+    static void setKeys(KeySet held);
+    static bool isKeyHeld(Key key){
+        return key != Key::NONE && keysHeld[static_cast<int>(key)];
+    }
+    static Key keyFromName(const std::string& name); // NONE if scratch has no such key
 
-    static std::vector<std::string> inputButtons;
     static void getInput();
     static std::string getUsername();
 
-};
\ No newline at end of file
+};
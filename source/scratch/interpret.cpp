@@ -1,20 +1,26 @@
 #include "interpret.hpp"
 #include "render.hpp"
+#include "compiler.hpp"
 
 std::vector<Sprite*> sprites;
-std::vector<Sprite> spritePool;
-std::vector<std::string> broadcastQueue;
+ClonePool clonePool;
+BroadcastQueue broadcastQueue;
 //std::unordered_map<std::string,Conditional> conditionals;
 std::unordered_map<std::string, Block*> blockLookup;
+GlobalScope globals;
 std::string answer;
 bool toExit = false;
 ProjectType projectType;
 
 BlockExecutor executor;
 
+Sprite* Scratch::stage = nullptr;
 int Scratch::projectWidth = 480;
 int Scratch::projectHeight = 360;
 int Scratch::FPS = 30;
+int Scratch::warpTimeBudget = 500;
+bool Scratch::turbo = false;
+int Scratch::maxClones = 300;
 
 std::string generateRandomString(int length) {
     std::string chars = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz1234567890-=[];',./_+{}|:<>?~`";
@@ -38,39 +44,41 @@ std::string removeQuotations(std::string value) {
     return value;
 }
 
-void initializeSpritePool(int poolSize) {
-    for (int i = 0; i < poolSize; i++) {
-        Sprite newSprite;
-        newSprite.id = generateRandomString(15);
-        newSprite.isClone = true;
-        newSprite.toDelete = true;
-        newSprite.isDeleted = true;
-        spritePool.push_back(newSprite);
-    }
+// adds a clone of the sprite to the project, nullptr if there are too many clones already
+Sprite* createClone(const Sprite& original) {
+    Sprite* clone = clonePool.acquire(original);
+    if (clone == nullptr) return nullptr;
+    sprites.push_back(clone);
+    registerHats(clone);
+    registerSprite(clone);
+    return clone;
 }
 
-Sprite* getAvailableSprite() {
-    for (Sprite& sprite : spritePool) {
-        if (sprite.isDeleted) {
-            sprite.isDeleted = false;
-            sprite.toDelete = false;
-            return &sprite;
-        }
-    }
-    return nullptr;  // No available sprites
+// the clone stops running right away, but stays in sprites until the end of the tick
+void deleteClone(Sprite* clone) {
+    if (!clone->isClone || clone->toDelete) return;
+    clone->toDelete = true;
+    clonePool.deleted.push_back(clone);
 }
 
 void cleanupSprites() {
+    // clones belong to the pool
     for (Sprite* sprite : sprites) {
-        delete sprite;
+        if (!sprite->isClone) delete sprite;
     }
 
-    spritePool.clear();
+    BlockExecutor::clearThreads();
+    clonePool.reset(Scratch::maxClones);
     sprites.clear();
+    // the masks are filed by costume id, another project's costumes could have the same ones
+    clearCollisionMasks();
+    Scratch::stage = nullptr;
+    globals = GlobalScope();
+    broadcastQueue = BroadcastQueue();
 }
 
-std::vector<std::pair<double, double>> getCollisionPoints(Sprite* currentSprite) {
-    std::vector<std::pair<double, double>> collisionPoints;
+std::array<std::pair<double, double>, 4> getCollisionPoints(const Sprite* currentSprite) {
+    std::array<std::pair<double, double>, 4> collisionPoints;
 
     // Get sprite dimensions, scaled by size
     double halfWidth = (currentSprite->spriteWidth * currentSprite->size / 100.0) / 2.0;
@@ -80,34 +88,64 @@ std::vector<std::pair<double, double>> getCollisionPoints(Sprite* currentSprite)
     double rotationRadians = (currentSprite->rotation - 90) * M_PI / 180.0;
 
     // Define the four corners relative to the sprite's center
-    std::vector<std::pair<double, double>> corners = {
+    const std::pair<double, double> corners[] = {
         { -halfWidth, -halfHeight }, // Top-left
         { halfWidth, -halfHeight },  // Top-right
         { halfWidth, halfHeight },   // Bottom-right
         { -halfWidth, halfHeight }   // Bottom-left
     };
 
+    double cosine = cos(rotationRadians);
+    double sine = sin(rotationRadians);
+
     // Rotate and translate each corner
-    for (const auto& corner : corners) {
-        double rotatedX = corner.first * cos(rotationRadians) - corner.second * sin(rotationRadians);
-        double rotatedY = corner.first * sin(rotationRadians) + corner.second * cos(rotationRadians);
+    for (int i = 0; i < 4; i++) {
+        const auto& corner = corners[i];
+        double rotatedX = corner.first * cosine - corner.second * sine;
+        double rotatedY = corner.first * sine + corner.second * cosine;
 
-        collisionPoints.emplace_back(
+        collisionPoints[i] = {
             currentSprite->xPosition + rotatedX,
             currentSprite->yPosition + rotatedY
-        );
+        };
     }
 
     return collisionPoints;
 }
 
+// input names the interpreter reads, anything else (extension inputs, prototype arguments) is dropped at load
+static int getInputSlot(const std::string& inputName){
+    static const std::unordered_map<std::string, int> slots = {
+        {"NUM", Block::NUM}, {"NUM1", Block::NUM1}, {"NUM2", Block::NUM2},
+        {"OPERAND", Block::OPERAND}, {"OPERAND1", Block::OPERAND1}, {"OPERAND2", Block::OPERAND2},
+        {"STRING1", Block::STRING1}, {"STRING2", Block::STRING2}, {"LETTER", Block::LETTER}, {"STRING", Block::STRING},
+        {"FROM", Block::FROM}, {"TO", Block::TO},
+        {"STEPS", Block::STEPS}, {"X", Block::X}, {"Y", Block::Y}, {"DX", Block::DX}, {"DY", Block::DY},
+        {"DEGREES", Block::DEGREES}, {"DIRECTION", Block::DIRECTION}, {"TOWARDS", Block::TOWARDS}, {"SECS", Block::SECS},
+        {"COSTUME", Block::COSTUME}, {"BACKDROP", Block::BACKDROP}, {"SIZE", Block::SIZE}, {"CHANGE", Block::CHANGE}, {"VALUE", Block::VALUE},
+        {"SOUND_MENU", Block::SOUND_MENU}, {"VOLUME", Block::VOLUME},
+        {"CONDITION", Block::CONDITION}, {"TIMES", Block::TIMES}, {"DURATION", Block::DURATION},
+        {"SUBSTACK", Block::SUBSTACK}, {"SUBSTACK2", Block::SUBSTACK2}, {"CLONE_OPTION", Block::CLONE_OPTION},
+        {"ITEM", Block::ITEM}, {"INDEX", Block::INDEX},
+        {"KEY_OPTION", Block::KEY_OPTION}, {"OBJECT", Block::OBJECT}, {"TOUCHINGOBJECTMENU", Block::TOUCHINGOBJECTMENU},
+        {"DISTANCETOMENU", Block::DISTANCETOMENU}, {"QUESTION", Block::QUESTION},
+        {"BROADCAST_INPUT", Block::BROADCAST_INPUT}, {"custom_block", Block::CUSTOM_BLOCK}
+    };
+    auto it = slots.find(inputName);
+    return it != slots.end() ? it->second : -1;
+}
+
 void loadSprites(const nlohmann::json& json){
     std::cout<<"Beginning to load sprites..."<< std::endl;
+    auto loadStart = std::chrono::steady_clock::now();
     sprites.reserve(400);
     int count = 0;
+    size_t blockCount = 0;
+    size_t unsupportedCount = 0;
     for (const auto& target : json["targets"]){ // "target" is sprite in Scratch speak, so for every sprite in sprites
     
         Sprite* newSprite = new Sprite();
+        newSprite->shared = std::make_shared<SharedSpriteData>();
         if(target.contains("name")){
         newSprite->name = target["name"].get<std::string>();}
         newSprite->id = generateRandomString(15);
@@ -155,7 +193,14 @@ void loadSprites(const nlohmann::json& json){
             newVariable.id = id;
             newVariable.name = data[0];
             newVariable.value = Value::fromJson(data[1]);
-            newSprite->variables[newVariable.id] = newVariable; // add variable to sprite
+            // stage variables are the globals
+            if(newSprite->isStage){
+                globals.variableSlots[newVariable.id] = globals.variables.size();
+                globals.variables.push_back(newVariable);
+            } else {
+                newSprite->shared->variableSlots[newVariable.id] = newSprite->variables.size();
+                newSprite->variables.push_back(newVariable); // add variable to sprite
+            }
         }
 
         // set Blocks
@@ -164,14 +209,29 @@ void loadSprites(const nlohmann::json& json){
             Block newBlock;
             newBlock.id = id;
             if (data.contains("opcode")){
-            newBlock.opcode = newBlock.stringToOpcode(data["opcode"].get<std::string>());}
+            newBlock.opcode = Block::stringToOpcode(data["opcode"].get_ref<const std::string&>());
+            if(newBlock.opcode == Block::NONE) unsupportedCount++;}
+            blockCount++;
             if (data.contains("next") && !data["next"].is_null()){
             newBlock.next = data["next"].get<std::string>();}
             if (data.contains("parent") && !data["parent"].is_null()){
             newBlock.parent = data["parent"].get<std::string>();}
             else newBlock.parent = "null";
             if (data.contains("fields")){
-            newBlock.fields = data["fields"];}
+                for (const auto& [fieldName, field] : data["fields"].items()){
+                    if (!field.is_array() || field.empty()) continue;
+                    if (field[0].is_string()) newBlock.field = field[0].get<std::string>();
+                    else if (field[0].is_number()) newBlock.field = field[0].dump();
+                    if ((fieldName == "VARIABLE" || fieldName == "LIST") && field.size() > 1 && field[1].is_string())
+                        newBlock.fieldId = field[1].get<std::string>();
+                }
+            }
+            // a call's arguments are keyed by argument id, keep them in the order the custom block lists them
+            std::vector<std::string> argumentIds;
+            if (newBlock.opcode == Block::PROCEDURES_CALL && data.contains("mutation") && data["mutation"].contains("argumentids")){
+                argumentIds = nlohmann::json::parse(data["mutation"]["argumentids"].get<std::string>()).get<std::vector<std::string>>();
+                newBlock.arguments.resize(argumentIds.size());
+            }
             if (data.contains("inputs")){
 
                 for(const auto& [inputName,inputData] : data["inputs"].items()){
@@ -202,7 +262,13 @@ void loadSprites(const nlohmann::json& json){
                         parsedInput.inputType = ParsedInput::LITERAL;
                         parsedInput.literalValue = Value::fromJson(inputValue);
                     }
-                    newBlock.parsedInputs[inputName] = parsedInput;
+                    if(newBlock.opcode == Block::PROCEDURES_CALL){
+                        auto argument = std::find(argumentIds.begin(), argumentIds.end(), inputName);
+                        if(argument != argumentIds.end()) newBlock.arguments[argument - argumentIds.begin()] = parsedInput;
+                        continue;
+                    }
+                    int slot = getInputSlot(inputName);
+                    if(slot != -1) newBlock.inputs[slot] = parsedInput;
                     //std::cout << "input: " << inputName << ". type = " << parsedInput.inputType << std::endl;
                 }
 
@@ -211,10 +277,10 @@ void loadSprites(const nlohmann::json& json){
             newBlock.topLevel = data["topLevel"].get<bool>();}
             if (data.contains("shadow")){
             newBlock.shadow = data["shadow"].get<bool>();}
-            if (data.contains("mutation")){
-                newBlock.mutation = data["mutation"];
+            if (newBlock.opcode == Block::PROCEDURES_CALL && data.contains("mutation") && data["mutation"].contains("proccode")){
+                newBlock.proccode = data["mutation"]["proccode"].get<std::string>();
             }
-            newSprite->blocks[newBlock.id] = newBlock; // add block
+            newSprite->shared->blocks[newBlock.id] = newBlock; // add block
 
 
             
@@ -253,7 +319,7 @@ void loadSprites(const nlohmann::json& json){
                 newCustomBlock.runWithoutScreenRefresh = true;}
                 else newCustomBlock.runWithoutScreenRefresh = false;
 
-                newSprite->customBlocks[newCustomBlock.name] = newCustomBlock; // add custom block
+                newSprite->shared->customBlocks[newCustomBlock.name] = newCustomBlock; // add custom block
             }
 
         }
@@ -268,7 +334,13 @@ void loadSprites(const nlohmann::json& json){
             for(const auto &listItem : data[1]){
             newList.items.push_back(Value::fromJson(listItem));
             }
-            newSprite->lists[newList.id] = newList; // add list
+            if(newSprite->isStage){
+                globals.listSlots[newList.id] = globals.lists.size();
+                globals.lists.push_back(newList);
+            } else {
+                newSprite->shared->listSlots[newList.id] = newSprite->lists.size();
+                newSprite->lists.push_back(newList); // add list
+            }
         }
 
         // set Sounds
@@ -280,7 +352,7 @@ void loadSprites(const nlohmann::json& json){
             newSound.dataFormat = data["dataFormat"];
             newSound.sampleRate = data["rate"];
             newSound.sampleCount = data["sampleCount"];
-            newSprite->sounds[newSound.id] = newSound;
+            newSprite->shared->sounds[newSound.id] = newSound;
         }
 
         // set Costumes
@@ -299,7 +371,7 @@ void loadSprites(const nlohmann::json& json){
             newCostume.rotationCenterX = data["rotationCenterX"];}
             if(data.contains("rotationCenterY")){
             newCostume.rotationCenterY = data["rotationCenterY"];}
-            newSprite->costumes.push_back(newCostume);
+            newSprite->shared->costumes.push_back(newCostume);
         }
 
        // set comments
@@ -314,7 +386,7 @@ void loadSprites(const nlohmann::json& json){
             newComment.x = data["x"];
             newComment.y = data["y"];
             newComment.text = data["text"];
-            newSprite->comments[newComment.id] = newComment;
+            newSprite->shared->comments[newComment.id] = newComment;
         }
 
         // set Broadcasts
@@ -322,11 +394,13 @@ void loadSprites(const nlohmann::json& json){
             Broadcast newBroadcast;
             newBroadcast.id = id;
             newBroadcast.name = data;
-            newSprite->broadcasts[newBroadcast.id] = newBroadcast;
+            globals.broadcasts[newBroadcast.id] = newBroadcast;
            // std::cout<<"broadcast name = "<< newBroadcast.name << std::endl;
         }
 
+        if(newSprite->isStage) Scratch::stage = newSprite;
         sprites.push_back(newSprite);
+        registerSprite(newSprite);
         count++;
 
 
@@ -335,24 +409,25 @@ void loadSprites(const nlohmann::json& json){
     // load block lookup table
     blockLookup.clear();
     for (Sprite* sprite : sprites) {
-        for (auto& [id, block] : sprite->blocks) {
+        for (auto& [id, block] : sprite->shared->blocks) {
             blockLookup[id] = &block;
         }
     }
-    // setup top level blocks
-    for (Sprite* currentSprite : sprites) {
-    for(auto& [id,block]: currentSprite->blocks){
-        if(block.topLevel) continue; // skip top level blocks
-        block.topLevelParentBlock = getBlockParent(&block)->id; // get parent block id
-        //std::cout<<"block id = "<< block.topLevelParentBlock << std::endl;
+    // link block ids into pointers, fold constant operators, then compile every script into its sprite's program
+    int folded = 0;
+    for (Sprite* sprite : sprites) {
+        linkSprite(sprite);
+        folded += foldConstants(sprite);
+        compileSprite(sprite);
+        registerHats(sprite);
     }
-}
+    std::cout << "Folded " << folded << " constant blocks." << std::endl;
+    broadcastQueue.reset(globals.receivers.size());
 
     // try to find the advanced project settings comment
     nlohmann::json config;
-    for (Sprite* currentSprite : sprites) {
-        if(!currentSprite->isStage) continue;
-        for(auto& [id,comment] : currentSprite->comments){
+    if (Scratch::stage != nullptr) {
+        for(auto& [id,comment] : Scratch::stage->shared->comments){
         std::size_t json_start = comment.text.find('{');
         if (json_start == std::string::npos) continue;
 
@@ -383,6 +458,24 @@ void loadSprites(const nlohmann::json& json){
     }
     catch(...){
         //std::cerr << "no framerate property." << std::endl;
+    }
+        try{
+       Scratch::warpTimeBudget = config["warpTime"].get<int>();
+    }
+    catch(...){
+        //std::cerr << "no warpTime property." << std::endl;
+    }
+        try{
+       Scratch::turbo = config["turbo"].get<bool>();
+    }
+    catch(...){
+        //std::cerr << "no turbo property." << std::endl;
+    }
+        try{
+       Scratch::maxClones = config["maxClones"].get<int>();
+    }
+    catch(...){
+        //std::cerr << "no maxClones property." << std::endl;
     }
         try{
        wdth = config["width"].get<int>();
@@ -409,34 +502,16 @@ void loadSprites(const nlohmann::json& json){
     // if unzipped, load initial sprites
     if(projectType == UNZIPPED){
         for(auto& currentSprite : sprites){
-            Image::loadImageFromFile(currentSprite->costumes[currentSprite->currentCostume].id);
+            Image::loadImageFromFile(currentSprite->shared->costumes[currentSprite->currentCostume].id);
         }
     }
 
 
-    initializeSpritePool(300);
-
-    // get block chains for every block
-    for (Sprite* currentSprite : sprites) {
-    for(auto& [id,block]: currentSprite->blocks){
-        if(!block.topLevel) continue;
-        std::string outID;
-        BlockChain chain;
-        chain.blockChain = getBlockChain(block.id,&outID);
-        currentSprite->blockChains[outID] = chain;
-        //std::cout << "ok = " << outID << std::endl;
-        block.blockChainID = outID;
-
-        for(auto& chainBlock : chain.blockChain) {
-            if(currentSprite->blocks.find(chainBlock->id) != currentSprite->blocks.end()) {
-                currentSprite->blocks[chainBlock->id].blockChainID = outID;
-            }
-        }
+    clonePool.reset(Scratch::maxClones);
 
-    }
-}
-
-    std::cout<<"Loaded " << sprites.size() << " sprites."<< std::endl;
+    std::chrono::duration<double, std::milli> loadTime = std::chrono::steady_clock::now() - loadStart;
+    std::cout<<"Loaded " << sprites.size() << " sprites and " << blockCount << " blocks in " << loadTime.count() << " ms"
+             << " (" << unsupportedCount << " blocks not supported)."<< std::endl;
 }
 
 
@@ -453,214 +528,197 @@ Block* findBlock(std::string blockId){
     return nullptr;
 }
 
-std::vector<Block*> getBlockChain(std::string blockId,std::string* outID){
-    std::vector<Block*> blockChain;
-    Block* currentBlock = findBlock(blockId);
-    while(currentBlock != nullptr){
-        blockChain.push_back(currentBlock);
-        if(outID)
-        *outID += currentBlock->id;
-
-        auto substackIt = currentBlock->parsedInputs.find("SUBSTACK");
-        if(substackIt != currentBlock->parsedInputs.end() && 
-           (substackIt->second.inputType == ParsedInput::BOOLEAN || substackIt->second.inputType == ParsedInput::BLOCK) &&
-           !substackIt->second.blockId.empty()){
-            
-            std::vector<Block*> subBlockChain;
-            subBlockChain = getBlockChain(substackIt->second.blockId, outID);
-            for(auto& block : subBlockChain){
-                blockChain.push_back(block);
-                if(outID)
-                    *outID += block->id;
-            }
-        }
+Value findCustomValue(const std::string& valueName, Sprite* sprite, Block& block) {
+    Thread* thread = BlockExecutor::currentThread;
+    if (thread == nullptr) return Value();
+
+    // the arguments belong to the innermost custom block the thread is running
+    for (auto frame = thread->frames.rbegin(); frame != thread->frames.rend(); ++frame) {
+        if (frame->procedure == nullptr) continue;
+
+        const CustomBlock& custBlock = *frame->procedure;
+        auto it = std::find(custBlock.argumentNames.begin(), custBlock.argumentNames.end(), valueName);
         
-        auto substack2It = currentBlock->parsedInputs.find("SUBSTACK2");
-        if(substack2It != currentBlock->parsedInputs.end() && 
-           (substack2It->second.inputType == ParsedInput::BOOLEAN || substack2It->second.inputType == ParsedInput::BLOCK) &&
-           !substack2It->second.blockId.empty()){
-            
-            std::vector<Block*> subBlockChain;
-            subBlockChain = getBlockChain(substack2It->second.blockId, outID);
-            for(auto& block : subBlockChain){
-                blockChain.push_back(block);
-                if(outID)
-                    *outID += block->id;
+        if (it != custBlock.argumentNames.end()) {
+            size_t index = std::distance(custBlock.argumentNames.begin(), it);
+
+            if (index < frame->arguments.size()) {
+                return frame->arguments[index];
+            } else {
+              std::cout << "Index out of bounds for argumentIds!" << std::endl;
             }
         }
-        currentBlock = findBlock(currentBlock->next);
+        break;
     }
-    return blockChain;
+    return Value();
 }
 
-Block* getBlockParent(const Block* block){
-    Block* parentBlock;
-    const Block* currentBlock = block;
-    while(currentBlock->parent != "null"){
-        parentBlock = findBlock(currentBlock->parent);
-        if(parentBlock != nullptr){
-            currentBlock = parentBlock;
-        }
-        else{
-            break;
-        }
+bool runCustomBlock(Sprite* sprite, Block& block, Thread* thread){
+    if(block.procedure == nullptr) return false;
+    const CustomBlock& data = *block.procedure;
+
+    // Get the parent of the prototype block (the definition containing all blocks)
+    Block* customBlockDefinition = sprite->shared->blocks[data.blockId].parentBlock;
+    if(customBlockDefinition == nullptr) return false;
+
+    // Set up argument values before pushing the frame, so argument reporters in them still read the caller's
+    std::vector<Value> arguments;
+    arguments.reserve(data.argumentIds.size());
+    for(size_t i = 0; i < data.argumentIds.size(); i++){
+        arguments.push_back(i < block.arguments.size() ? Scratch::getInputValue(block.arguments[i], sprite) : Value());
     }
-    return const_cast<Block*>(currentBlock);
-}
 
+    //std::cout << "running custom block " << data.blockId << std::endl;
 
+    // a warp custom block runs without screen refresh, and so does everything it calls
+    Frame& frame = thread->startBranch(customBlockDefinition->pc, false);
+    frame.warp = frame.warp || data.runWithoutScreenRefresh;
+    if(frame.warp) BlockExecutor::startWarpTimer(*thread);
+    frame.procedure = &data;
+    frame.arguments = std::move(arguments);
+    return true;
+}
 
 
-Value findCustomValue(std::string valueName, Sprite* sprite, Block block) {
-    for (auto& [custId, custBlock] : sprite->customBlocks) {
 
-        auto it = std::find(custBlock.argumentNames.begin(), custBlock.argumentNames.end(), valueName);
-        
-        if (it != custBlock.argumentNames.end()) {
-            size_t index = std::distance(custBlock.argumentNames.begin(), it);
 
-            if (index < custBlock.argumentIds.size()) {
-                std::string argumentId = custBlock.argumentIds[index];
+int internBroadcast(const std::string& name){
+    auto it = globals.broadcastIds.find(name);
+    if (it != globals.broadcastIds.end()) return it->second;
+    int id = globals.receivers.size();
+    globals.broadcastIds[name] = id;
+    globals.receivers.emplace_back();
+    return id;
+}
 
-                auto valueIt = custBlock.argumentValues.find(argumentId);
-                if (valueIt != custBlock.argumentValues.end()) {
-                   //std::cout << "FOUND that shit BAAANG: " << valueIt->second.asString() << std::endl;
-                    return valueIt->second;
-                } else {
-                   std::cout << "Argument ID found, but no value exists for it." << std::endl;
-                }
-            } else {
-              std::cout << "Index out of bounds for argumentIds!" << std::endl;
-            }
-        }
-    }
-    return Value();
+int findBroadcast(const std::string& name){
+    auto it = globals.broadcastIds.find(name);
+    return it != globals.broadcastIds.end() ? it->second : -1;
 }
 
-void runCustomBlock(Sprite* sprite,Block& block, Block* callerBlock,bool* withoutScreenRefresh){
-    for(auto &[id, data] : sprite->customBlocks){
-        if(id == block.mutation.at("proccode").get<std::string>()){
-            // Set up argument values
-            for(std::string arg : data.argumentIds){
-                if(block.parsedInputs.find(arg) != block.parsedInputs.end()){
-                    data.argumentValues[arg] = Scratch::getInputValue(block, arg,sprite);
-                }
-            }
-            
-            //std::cout << "running custom block " << data.blockId << std::endl;
-            
-            // Get the parent of the prototype block (the definition containing all blocks)
-            Block* customBlockDefinition = &sprite->blocks[sprite->blocks[data.blockId].parent];
-            
-            callerBlock->customBlockPtr = customBlockDefinition;
+void registerHats(Sprite* sprite){
+    for (Block* hat : sprite->shared->broadcastHats) {
+        globals.receivers[hat->broadcast].push_back({hat, sprite});
+    }
+    for (Block* hat : sprite->shared->flagHats) {
+        globals.flagHats.push_back({hat, sprite});
+    }
+    for (Block* hat : sprite->shared->keyHats) {
+        globals.keyHats[static_cast<int>(hat->key)].push_back({hat, sprite});
+    }
+}
 
-            bool localWithoutRefresh = data.runWithoutScreenRefresh;
+static void removeHat(std::vector<std::pair<Block*, Sprite*>>& hats, Block* hat, Sprite* sprite){
+    hats.erase(std::remove(hats.begin(), hats.end(), std::make_pair(hat, sprite)), hats.end());
+}
 
-            
-            // If the parent chain is running without refresh, force this one to also run without refresh
-            if(!localWithoutRefresh && withoutScreenRefresh != nullptr) {
-                localWithoutRefresh = *withoutScreenRefresh;
-            }
-            
-            //std::cout << "RWSR = " << localWithoutRefresh << std::endl;
-            
-            // Execute the custom block definition
-            executor.runBlock(*customBlockDefinition, sprite, nullptr, &localWithoutRefresh);
+void unregisterHats(Sprite* sprite){
+    for (Block* hat : sprite->shared->broadcastHats) {
+        removeHat(globals.receivers[hat->broadcast], hat, sprite);
+    }
+    for (Block* hat : sprite->shared->flagHats) {
+        removeHat(globals.flagHats, hat, sprite);
+    }
+    for (Block* hat : sprite->shared->keyHats) {
+        removeHat(globals.keyHats[static_cast<int>(hat->key)], hat, sprite);
+    }
+}
 
-            if(localWithoutRefresh){
-                BlockExecutor::runRepeatsWithoutRefresh(sprite,customBlockDefinition->blockChainID);
-            }
-            
-            break;
-        }
+VariableRef resolveVariable(const std::string& variableId, Sprite* sprite){
+    VariableRef variable;
+    auto it = sprite->shared->variableSlots.find(variableId);
+    if (it != sprite->shared->variableSlots.end()) {
+        variable.scope = VariableRef::LOCAL;
+        variable.slot = it->second;
+        return variable;
     }
+    auto globalIt = globals.variableSlots.find(variableId);
+    if (globalIt != globals.variableSlots.end()) {
+        variable.scope = VariableRef::GLOBAL;
+        variable.slot = globalIt->second;
+    }
+    return variable;
 }
 
+// a list used as a reporter reads as its items joined by spaces
+static Value joinList(const List& list){
+    std::string result;
+    for (const auto& item : list.items) {
+        result += item.asString() + " ";
+    }
+    if (!result.empty()) result.pop_back();
+    return Value(result);
+}
 
+ListRef resolveList(const std::string& listId, Sprite* sprite){
+    ListRef list;
+    auto it = sprite->shared->listSlots.find(listId);
+    if (it != sprite->shared->listSlots.end()) {
+        list.scope = ListRef::LOCAL;
+        list.slot = it->second;
+        return list;
+    }
+    auto globalIt = globals.listSlots.find(listId);
+    if (globalIt != globals.listSlots.end()) {
+        list.scope = ListRef::GLOBAL;
+        list.slot = globalIt->second;
+    }
+    return list;
+}
 
+List* findList(const std::string& listId, Sprite* sprite){
+    return listOf(resolveList(listId, sprite), sprite);
+}
 
 void setVariableValue(const std::string& variableId, const Value& newValue, Sprite* sprite) {
-    // Set sprite variable
-    auto it = sprite->variables.find(variableId);
-    if (it != sprite->variables.end()) {
-        it->second.value = newValue;
-        return;
-    }
-    
-    // Set global variable
-    for (auto& currentSprite : sprites) {
-        if (currentSprite->isStage) {
-            auto globalIt = currentSprite->variables.find(variableId);
-            if (globalIt != currentSprite->variables.end()) {
-                globalIt->second.value = newValue;
-                return;
-            }
-        }
+    VariableRef variable = resolveVariable(variableId, sprite);
+    if (variable.scope != VariableRef::UNRESOLVED) {
+        variableValue(variable, sprite) = newValue;
     }
 }
 
 Value getVariableValue(std::string variableId, Sprite* sprite) {
-    // Check sprite variables
-    auto it = sprite->variables.find(variableId);
-    if (it != sprite->variables.end()) {
-        return it->second.value;  // Fast conversion
+    VariableRef variable = resolveVariable(variableId, sprite);
+    if (variable.scope != VariableRef::UNRESOLVED) {
+        return variableValue(variable, sprite);
     }
     
     // Check lists
-    auto listIt = sprite->lists.find(variableId);
-    if (listIt != sprite->lists.end()) {
-        std::string result;
-        for (const auto& item : listIt->second.items) {
-            result += item.asString() + " ";
-        }
-        if (!result.empty()) result.pop_back();
-        Value val(result);
-        return val;
-    }
-    
-    // Check global variables
-    for (const auto& currentSprite : sprites) {
-        if (currentSprite->isStage) {
-            auto globalIt = currentSprite->variables.find(variableId);
-            if (globalIt != currentSprite->variables.end()) {
-                return globalIt->second.value;
-            }
-        }
+    List* list = findList(variableId, sprite);
+    if (list != nullptr) {
+        return joinList(*list);
     }
     
     return Value(0);
 }
 
-Value Scratch::getInputValue(Block& block, const std::string& inputName, Sprite* sprite){
-        auto parsedFind = block.parsedInputs.find(inputName);
+Value Scratch::getInputValue(Block& block, int slot, Sprite* sprite){
+        return getInputValue(block.inputs[slot], sprite);
+    }
 
-        if (parsedFind == block.parsedInputs.end()) {
-            return Value(0);
-        }
-        
-        const ParsedInput& input = parsedFind->second;
+Value Scratch::getInputValue(const ParsedInput& input, Sprite* sprite){
         switch(input.inputType) {
 
             case ParsedInput::LITERAL:
-                // Check if literal string value is actually a block ID
-                if (input.literalValue.isString()) {
-                    std::string strValue = input.literalValue.asString();
-                    Block* foundBlock = findBlock(strValue);
-                    if (foundBlock != nullptr) {
-                        // It's a block ID, evaluate the block
-                        return executor.getBlockValue(*foundBlock, sprite);
-                    }
+                // a literal naming a block (menus) evaluates that block
+                if (input.block != nullptr) {
+                    return executor.getBlockValue(*input.block, sprite);
                 }
                 return input.literalValue;
                 
             case ParsedInput::VARIABLE:
+                if (input.variable.scope != VariableRef::UNRESOLVED) {
+                    return variableValue(input.variable, sprite);
+                }
+                if (input.list.scope != ListRef::UNRESOLVED) {
+                    return joinList(*listOf(input.list, sprite));
+                }
                 return getVariableValue(input.variableId, sprite);
                 
             case ParsedInput::BLOCK:
-                return executor.getBlockValue(*findBlock(input.blockId), sprite);
-                
             case ParsedInput::BOOLEAN:
-                return executor.getBlockValue(*findBlock(input.blockId), sprite);
+                if (input.block == nullptr) return Value(0);
+                return executor.getBlockValue(*input.block, sprite);
                 
         }
         return Value(0);
@@ -671,13 +729,55 @@ Value Scratch::getInputValue(Block& block, const std::string& inputName, Sprite*
 
 std::vector<Sprite*> findSprite(std::string spriteName){
     std::vector<Sprite*> sprts;
-    for(Sprite* currentSprite : sprites){
-        if(currentSprite->name == spriteName){
-            sprts.push_back(currentSprite);
-        }
-    }
+    const SpriteEntry* entry = findSpriteEntry(findSpriteId(spriteName));
+    if(entry == nullptr) return sprts;
+    if(entry->original != nullptr) sprts.push_back(entry->original);
+    sprts.insert(sprts.end(), entry->clones.begin(), entry->clones.end());
     return sprts;
 }
 
+void registerSprite(Sprite* sprite){
+    // a clone starts with the original's slot, but isn't filed anywhere yet
+    sprite->gridSlot = GridSlot();
+    markMoved(sprite);
+    if(sprite->isClone){
+        if(sprite->nameId >= 0) globals.spriteEntries[sprite->nameId].clones.push_back(sprite);
+        return;
+    }
+    auto it = globals.spriteIds.find(sprite->name);
+    if(it == globals.spriteIds.end()){
+        it = globals.spriteIds.emplace(sprite->name, globals.spriteEntries.size()).first;
+        globals.spriteEntries.emplace_back();
+    }
+    sprite->nameId = it->second;
+    globals.spriteEntries[sprite->nameId].original = sprite;
+}
+
+void unregisterSprite(Sprite* sprite){
+    if(!sprite->isClone || sprite->nameId < 0) return;
+    globals.spriteEntries[sprite->nameId].grid.remove(sprite);
+    std::vector<Sprite*>& clones = globals.spriteEntries[sprite->nameId].clones;
+    auto it = std::find(clones.begin(), clones.end(), sprite);
+    if(it == clones.end()) return;
+    // clones aren't kept in any order, so the last one can fill the gap
+    *it = clones.back();
+    clones.pop_back();
+}
+
+int findSpriteId(const std::string& name){
+    auto it = globals.spriteIds.find(name);
+    return it != globals.spriteIds.end() ? it->second : -1;
+}
+
+Sprite* findOriginal(int spriteId){
+    if(spriteId < 0 || spriteId >= static_cast<int>(globals.spriteEntries.size())) return nullptr;
+    return globals.spriteEntries[spriteId].original;
+}
+
+const SpriteEntry* findSpriteEntry(int spriteId){
+    if(spriteId < 0 || spriteId >= static_cast<int>(globals.spriteEntries.size())) return nullptr;
+    return &globals.spriteEntries[spriteId];
+}
+
 
 
@@ -28,37 +28,71 @@ extern BlockExecutor executor;
 extern ProjectType projectType;
 
 extern std::vector<Sprite*> sprites;
-extern std::vector<Sprite> spritePool;
-extern std::vector<std::string> broadcastQueue;
+extern ClonePool clonePool;
+extern BroadcastQueue broadcastQueue;
 //extern std::unordered_map<std::string,Conditional> conditionals;
 extern std::unordered_map<std::string, Block*> blockLookup;
+extern GlobalScope globals;
 extern bool toExit;
 extern std::string answer;
 
 class Scratch{
 public:
-    static Value getInputValue(Block& block, const std::string& inputName, Sprite* sprite);
+    static Value getInputValue(Block& block, int slot, Sprite* sprite);
+    static Value getInputValue(const ParsedInput& input, Sprite* sprite);
+
+    static Sprite* stage;
 
     static int projectWidth;
     static int projectHeight;
     static int FPS;
+    static int warpTimeBudget; // milliseconds warp scripts may run each frame before they have to yield
+    static bool turbo; // run as many ticks as fit in a frame instead of one
+    static int maxClones; // clones that can be alive at once, creating more does nothing
 };
 
 
-std::vector<std::pair<double, double>> getCollisionPoints(Sprite* currentSprite);
+std::array<std::pair<double, double>, 4> getCollisionPoints(const Sprite* currentSprite);
 void loadSprites(const nlohmann::json& json);
 void cleanupSprites();
-Block* getBlockParent(const Block* block);
-void initializeSpritePool(int poolSize);
-Sprite* getAvailableSprite();
-void initializeSpritePool(int poolSize);
-Value findCustomValue(std::string valueName,Sprite*sprite,Block block);
+Sprite* createClone(const Sprite& original);
+void deleteClone(Sprite* clone);
+Value findCustomValue(const std::string& valueName, Sprite* sprite, Block& block);
 std::string removeQuotations(std::string value);
-void runCustomBlock(Sprite* sprite,Block& block, Block* callerBlock,bool* withoutScreenRefresh);
+bool runCustomBlock(Sprite* sprite, Block& block, Thread* thread);
 Block* findBlock(std::string blockId);
 std::vector<Sprite*> findSprite(std::string spriteName);
 
+// sprites by interned name. the original is registered on load, clones when they're created and deleted
+void registerSprite(Sprite* sprite);
+void unregisterSprite(Sprite* sprite);
+int findSpriteId(const std::string& name); // -1 if no sprite has that name
+Sprite* findOriginal(int spriteId);
+const SpriteEntry* findSpriteEntry(int spriteId);
+
+// broadcasts are matched by an id interned from their name. -1 when nothing receives the name
+int internBroadcast(const std::string& name);
+int findBroadcast(const std::string& name);
+// adds or removes the sprite's hats from the indexes in globals
+void registerHats(Sprite* sprite);
+void unregisterHats(Sprite* sprite);
+
+VariableRef resolveVariable(const std::string& variableId, Sprite* sprite);
+ListRef resolveList(const std::string& listId, Sprite* sprite);
+List* findList(const std::string& listId, Sprite* sprite);
 Value getVariableValue(std::string variableId,Sprite*sprite);
 void setVariableValue(const std::string& variableId, const Value& newValue, Sprite* sprite);
+
+// the ref must be resolved
+inline Value& variableValue(const VariableRef& variable, Sprite* sprite){
+    if(variable.scope == VariableRef::GLOBAL) return globals.variables[variable.slot].value;
+    return sprite->variables[variable.slot].value;
+}
+
+// nullptr when the ref didn't resolve
+inline List* listOf(const ListRef& list, Sprite* sprite){
+    if(list.scope == ListRef::GLOBAL) return &globals.lists[list.slot];
+    if(list.scope == ListRef::LOCAL) return &sprite->lists[list.slot];
+    return nullptr;
+}
 std::string generateRandomString(int length);
-std::vector<Block*> getBlockChain(std::string blockId,std::string* outID = nullptr);
@@ -0,0 +1,32 @@
+#include "input.hpp"
+#include <cctype>
+
+Input::KeySet Input::keysHeld;
+Input::KeySet Input::keysPressed;
+
+void Input::setKeys(KeySet held){
+    held[static_cast<int>(Key::ANY)] = false;
+    KeySet pressed = held & ~keysHeld;
+    // any fires again for every key that goes down, not just the first
+    if(pressed.any()) pressed.set(static_cast<int>(Key::ANY));
+    if(held.any()) held.set(static_cast<int>(Key::ANY));
+    keysPressed = pressed;
+    keysHeld = held;
+}
+
+Input::Key Input::keyFromName(const std::string& name){
+    if(name.size() == 1){
+        char c = std::tolower(static_cast<unsigned char>(name[0]));
+        if(c >= 'a' && c <= 'z') return static_cast<Key>(static_cast<int>(Key::A) + (c - 'a'));
+        if(c >= '0' && c <= '9') return static_cast<Key>(static_cast<int>(Key::DIGIT_0) + (c - '0'));
+        if(c == ' ') return Key::SPACE;
+        return Key::NONE;
+    }
+    if(name == "space") return Key::SPACE;
+    if(name == "up arrow") return Key::UP_ARROW;
+    if(name == "down arrow") return Key::DOWN_ARROW;
+    if(name == "left arrow") return Key::LEFT_ARROW;
+    if(name == "right arrow") return Key::RIGHT_ARROW;
+    if(name == "any") return Key::ANY;
+    return Key::NONE;
+}
@@ -2,6 +2,7 @@
 #include <string>
 #include <cmath>
 #include <algorithm>
+#include <cstdlib>
 #ifndef M_PI
 #define M_PI 3.14159265358979323846
 #endif
@@ -9,19 +10,25 @@
 class Math{
     public:
 
-    static bool isNumber(const std::string& str) {
-        // i rewrote this function like 5 times vro if ts dont work...
-        if (str.empty()) return false;
-
-        size_t start = 0;
-        if (str[0] == '-') { // Allow negative numbers
-            if (str.size() == 1) return false; // just "-" alone is invalid
-            start = 1; // Skip '-' for digit checking
+    // one pass over the string: an optional '-', then digits with at most one '.', and at least one digit.
+    // writes the number to out (if given) and returns false when the string isn't one
+    static bool parseNumber(const std::string& str, double* out) {
+        size_t start = (!str.empty() && str[0] == '-') ? 1 : 0;
+        bool hasDigit = false;
+        bool hasDot = false;
+        for (size_t i = start; i < str.size(); i++) {
+            char c = str[i];
+            if (c >= '0' && c <= '9') hasDigit = true;
+            else if (c == '.' && !hasDot) hasDot = true;
+            else return false;
         }
+        if (!hasDigit) return false;
+        if (out) *out = std::strtod(str.c_str(), nullptr);
+        return true;
+    }
 
-        return std::count(str.begin() + start, str.end(), '.') <= 1 && // At most one decimal point
-            std::any_of(str.begin() + start, str.end(), ::isdigit) && // At least one digit
-            std::all_of(str.begin() + start, str.end(), [](char c) { return std::isdigit(c) || c == '.'; });
+    static bool isNumber(const std::string& str) {
+        return parseNumber(str, nullptr);
     }
 
     static double degreesToRadians(double degrees) {
@@ -0,0 +1,117 @@
+#include "spatialGrid.hpp"
+#include "interpret.hpp"
+#include <algorithm>
+#include <cmath>
+
+static uint32_t nextQueryStamp = 0;
+
+Bounds collisionBounds(Sprite* sprite){
+    const StageMask* mask = stageMaskOf(sprite);
+    if(mask != nullptr) return stageMaskBounds(sprite, *mask);
+
+    // without a mask, touching checks test the scaled, rotated corners of one sprite against the
+    // unscaled box of the other, so the bounds cover both. the corners are never further out than the half diagonal
+    double scale = sprite->size / 100.0;
+    double halfDiagonal = std::hypot(sprite->spriteWidth * scale, sprite->spriteHeight * scale) / 2.0;
+    double halfWidth = std::max(sprite->spriteWidth / 2.0, halfDiagonal);
+    double halfHeight = std::max(sprite->spriteHeight / 2.0, halfDiagonal);
+    return {sprite->xPosition - halfWidth, sprite->xPosition + halfWidth,
+            sprite->yPosition - halfHeight, sprite->yPosition + halfHeight};
+}
+
+int SpatialGrid::cellColumn(double x) const {
+    int column = static_cast<int>(std::floor((x + Scratch::projectWidth / 2.0) / cellSize));
+    return std::clamp(column, 0, columns - 1);
+}
+
+int SpatialGrid::cellRow(double y) const {
+    int row = static_cast<int>(std::floor((y + Scratch::projectHeight / 2.0) / cellSize));
+    return std::clamp(row, 0, rows - 1);
+}
+
+void SpatialGrid::insert(Sprite* sprite){
+    if(cells.empty()){
+        columns = std::max(1, (Scratch::projectWidth + cellSize - 1) / cellSize);
+        rows = std::max(1, (Scratch::projectHeight + cellSize - 1) / cellSize);
+        cells.resize(columns * rows);
+    }
+
+    Bounds bounds = collisionBounds(sprite);
+    GridSlot& slot = sprite->gridSlot;
+    int left = cellColumn(bounds.left);
+    int right = cellColumn(bounds.right);
+    int bottom = cellRow(bounds.bottom);
+    int top = cellRow(bounds.top);
+    slot.width = sprite->spriteWidth;
+    slot.height = sprite->spriteHeight;
+    if(left == slot.left && right == slot.right && bottom == slot.bottom && top == slot.top) return;
+
+    remove(sprite);
+    for(int row = bottom; row <= top; row++){
+        for(int column = left; column <= right; column++){
+            cells[row * columns + column].push_back(sprite);
+        }
+    }
+    slot.left = left;
+    slot.right = right;
+    slot.bottom = bottom;
+    slot.top = top;
+}
+
+void SpatialGrid::remove(Sprite* sprite){
+    GridSlot& slot = sprite->gridSlot;
+    for(int row = slot.bottom; row <= slot.top; row++){
+        for(int column = slot.left; column <= slot.right; column++){
+            std::vector<Sprite*>& cell = cells[row * columns + column];
+            auto it = std::find(cell.begin(), cell.end(), sprite);
+            if(it == cell.end()) continue;
+            *it = cell.back();
+            cell.pop_back();
+        }
+    }
+    slot.left = 0;
+    slot.right = -1;
+    slot.bottom = 0;
+    slot.top = -1;
+}
+
+void SpatialGrid::query(const Bounds& bounds, std::vector<Sprite*>& found) const {
+    if(cells.empty()) return;
+    uint32_t stamp = ++nextQueryStamp;
+    int left = cellColumn(bounds.left);
+    int right = cellColumn(bounds.right);
+    int bottom = cellRow(bounds.bottom);
+    int top = cellRow(bounds.top);
+    for(int row = bottom; row <= top; row++){
+        for(int column = left; column <= right; column++){
+            for(Sprite* sprite : cells[row * columns + column]){
+                if(sprite->gridSlot.queryStamp == stamp) continue;
+                sprite->gridSlot.queryStamp = stamp;
+                found.push_back(sprite);
+            }
+        }
+    }
+}
+
+void markMoved(Sprite* sprite){
+    if(sprite->gridSlot.moved || sprite->isStage) return;
+    sprite->gridSlot.moved = true;
+    globals.movedSprites.push_back(sprite);
+}
+
+void markResizedSprites(){
+    for(Sprite* sprite : sprites){
+        if(sprite->spriteWidth != sprite->gridSlot.width || sprite->spriteHeight != sprite->gridSlot.height) markMoved(sprite);
+    }
+}
+
+void updateMovedSprites(){
+    for(Sprite* sprite : globals.movedSprites){
+        if(!sprite->gridSlot.moved) continue;
+        sprite->gridSlot.moved = false;
+        // a deleted clone was already taken out of its grid
+        if(sprite->isDeleted || sprite->nameId < 0) continue;
+        globals.spriteEntries[sprite->nameId].grid.insert(sprite);
+    }
+    globals.movedSprites.clear();
+}
@@ -0,0 +1,55 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+class Sprite;
+
+// an axis aligned box in stage coordinates
+struct Bounds {
+    double left;
+    double right;
+    double bottom;
+    double top;
+};
+
+// the cells a sprite is filed under, kept on the sprite so it can be taken out again
+struct GridSlot {
+    int left = 0;
+    int right = -1; // not filed anywhere while right < left
+    int bottom = 0;
+    int top = -1;
+    int width = 0; // the sprite's size when it was filed, the renderer can change it
+    int height = 0;
+    bool moved = false; // waiting in globals.movedSprites
+    uint32_t queryStamp = 0; // the last query that returned it, so it isn't returned twice
+};
+
+// a uniform grid over the bounds of a sprite and its clones, so touching checks only look at
+// the ones near the sprite asking. a sprite is filed under every cell its bounds overlap.
+// the grid covers the stage, anything past the edge is filed under the edge cells
+class SpatialGrid {
+public:
+    static constexpr int cellSize = 60;
+
+    // files the sprite under the cells it overlaps now, taking it out of the ones it left
+    void insert(Sprite* sprite);
+    void remove(Sprite* sprite);
+    // adds every sprite filed under a cell the bounds overlap, each once
+    void query(const Bounds& bounds, std::vector<Sprite*>& found) const;
+
+private:
+    int cellColumn(double x) const;
+    int cellRow(double y) const;
+
+    int columns = 0;
+    int rows = 0;
+    std::vector<std::vector<Sprite*>> cells; // row by row
+};
+
+// bounds that hold everything touching checks test for the sprite
+Bounds collisionBounds(Sprite* sprite);
+// queues the sprite to be refiled in its grid before the next touching check
+void markMoved(Sprite* sprite);
+// also queues sprites whose size the renderer changed since they were filed
+void markResizedSprites();
+void updateMovedSprites();
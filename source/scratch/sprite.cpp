@@ -1,22 +1,212 @@
 #include "sprite.hpp"
 #include "interpret.hpp"
 
+struct OpcodeName {
+    std::string_view name;
+    Block::opCode opcode;
+};
+
+// every opcode scratch 3 saves, sorted by name so loading can binary search it.
+// the ones mapped to NONE exist in scratch but aren't supported here yet
+static constexpr OpcodeName opcodeNames[] = {
+    {"argument_reporter_boolean",        Block::ARGUMENT_REPORTER_BOOLEAN},
+    {"argument_reporter_string_number",  Block::ARGUMENT_REPORTER_STRING_NUMBER},
+    {"control_all_at_once",              Block::NONE},
+    {"control_clear_counter",            Block::NONE},
+    {"control_create_clone_of",          Block::CONTROL_CREATE_CLONE_OF},
+    {"control_create_clone_of_menu",     Block::CONTROL_CREATE_CLONE_OF_MENU},
+    {"control_delete_this_clone",        Block::CONTROL_DELETE_THIS_CLONE},
+    {"control_for_each",                 Block::NONE},
+    {"control_forever",                  Block::CONTROL_FOREVER},
+    {"control_get_counter",              Block::NONE},
+    {"control_if",                       Block::CONTROL_IF},
+    {"control_if_else",                  Block::CONTROL_IF_ELSE},
+    {"control_incr_counter",             Block::NONE},
+    {"control_repeat",                   Block::CONTROL_REPEAT},
+    {"control_repeat_until",             Block::CONTROL_REPEAT_UNTIL},
+    {"control_start_as_clone",           Block::CONTROL_START_AS_CLONE},
+    {"control_stop",                     Block::CONTROL_STOP},
+    {"control_wait",                     Block::CONTROL_WAIT},
+    {"control_wait_until",               Block::CONTROL_WAIT_UNTIL},
+    {"control_while",                    Block::CONTROL_WHILE},
+    {"data_addtolist",                   Block::DATA_ADD_TO_LIST},
+    {"data_changevariableby",            Block::DATA_CHANGEVARIABLEBY},
+    {"data_deletealloflist",             Block::DATA_DELETE_ALL_OF_LIST},
+    {"data_deleteoflist",                Block::DATA_DELETE_OF_LIST},
+    {"data_hidelist",                    Block::NONE},
+    {"data_hidevariable",                Block::NONE},
+    {"data_insertatlist",                Block::DATA_INSERT_AT_LIST},
+    {"data_itemnumoflist",               Block::DATA_ITEMNUMOFLIST},
+    {"data_itemoflist",                  Block::DATA_ITEMOFLIST},
+    {"data_lengthoflist",                Block::DATA_LENGTHOFLIST},
+    {"data_listcontainsitem",            Block::DATA_LIST_CONTAINS_ITEM},
+    {"data_listcontents",                Block::NONE},
+    {"data_replaceitemoflist",           Block::DATA_REPLACE_ITEM_OF_LIST},
+    {"data_setvariableto",               Block::DATA_SETVARIABLETO},
+    {"data_showlist",                    Block::NONE},
+    {"data_showvariable",                Block::NONE},
+    {"data_variable",                    Block::NONE},
+    {"event_broadcast",                  Block::EVENT_BROADCAST},
+    {"event_broadcastandwait",           Block::EVENT_BROADCASTANDWAIT},
+    {"event_touchingobjectmenu",         Block::NONE},
+    {"event_whenbackdropswitchesto",     Block::NONE},
+    {"event_whenbroadcastreceived",      Block::EVENT_WHENBROADCASTRECEIVED},
+    {"event_whenflagclicked",            Block::EVENT_WHENFLAGCLICKED},
+    {"event_whengreaterthan",            Block::NONE},
+    {"event_whenkeypressed",             Block::EVENT_WHEN_KEY_PRESSED},
+    {"event_whenstageclicked",           Block::NONE},
+    {"event_whenthisspriteclicked",      Block::NONE},
+    {"event_whentouchingobject",         Block::NONE},
+    {"looks_backdropnumbername",         Block::LOOKS_BACKDROPNUMBERNAME},
+    {"looks_backdrops",                  Block::LOOKS_BACKDROPS},
+    {"looks_changeeffectby",             Block::LOOKS_CHANGE_EFFECT_BY},
+    {"looks_changesizeby",               Block::LOOKS_CHANGESIZEBY},
+    {"looks_changestretchby",            Block::NONE},
+    {"looks_cleargraphiceffects",        Block::LOOKS_CLEAR_GRAPHIC_EFFECTS},
+    {"looks_costume",                    Block::LOOKS_COSTUME},
+    {"looks_costumenumbername",          Block::LOOKS_COSTUMENUMBERNAME},
+    {"looks_goforwardbackwardlayers",    Block::LOOKS_GO_FORWARD_BACKWARD_LAYERS},
+    {"looks_gotofrontback",              Block::LOOKS_GO_TO_FRONT_BACK},
+    {"looks_hide",                       Block::LOOKS_HIDE},
+    {"looks_hideallsprites",             Block::NONE},
+    {"looks_nextbackdrop",               Block::LOOKS_NEXTBACKDROP},
+    {"looks_nextcostume",                Block::LOOKS_NEXTCOSTUME},
+    {"looks_say",                        Block::NONE},
+    {"looks_sayforsecs",                 Block::NONE},
+    {"looks_seteffectto",                Block::LOOKS_SET_EFFECT_TO},
+    {"looks_setsizeto",                  Block::LOOKS_SETSIZETO},
+    {"looks_setstretchto",               Block::NONE},
+    {"looks_show",                       Block::LOOKS_SHOW},
+    {"looks_size",                       Block::LOOKS_SIZE},
+    {"looks_switchbackdropto",           Block::LOOKS_SWITCHBACKDROPTO},
+    {"looks_switchbackdroptoandwait",    Block::NONE},
+    {"looks_switchcostumeto",            Block::LOOKS_SWITCHCOSTUMETO},
+    {"looks_think",                      Block::NONE},
+    {"looks_thinkforsecs",               Block::NONE},
+    {"motion_align_scene",               Block::NONE},
+    {"motion_changexby",                 Block::MOTION_CHANGEXBY},
+    {"motion_changeyby",                 Block::MOTION_CHANGEYBY},
+    {"motion_direction",                 Block::MOTION_DIRECTION},
+    {"motion_glidesecstoxy",             Block::MOTION_GLIDE_SECS_TO_XY},
+    {"motion_glideto",                   Block::MOTION_GLIDE_TO},
+    {"motion_glideto_menu",              Block::MOTION_GLIDE_TO_MENU},
+    {"motion_goto",                      Block::MOTION_GOTO},
+    {"motion_goto_menu",                 Block::MOTION_GOTO_MENU},
+    {"motion_gotoxy",                    Block::MOTION_GOTOXY},
+    {"motion_ifonedgebounce",            Block::MOTION_IF_ON_EDGE_BOUNCE},
+    {"motion_movesteps",                 Block::MOTION_MOVE_STEPS},
+    {"motion_pointindirection",          Block::MOTION_POINTINDIRECTION},
+    {"motion_pointtowards",              Block::MOTION_POINT_TOWARD},
+    {"motion_pointtowards_menu",         Block::MOTION_POINT_TOWARD_MENU},
+    {"motion_scroll_right",              Block::NONE},
+    {"motion_scroll_up",                 Block::NONE},
+    {"motion_setrotationstyle",          Block::MOTION_SET_ROTATION_STYLE},
+    {"motion_setx",                      Block::MOTION_SETX},
+    {"motion_sety",                      Block::MOTION_SETY},
+    {"motion_turnleft",                  Block::MOTION_TURNLEFT},
+    {"motion_turnright",                 Block::MOTION_TURNRIGHT},
+    {"motion_xposition",                 Block::MOTION_XPOSITION},
+    {"motion_xscroll",                   Block::NONE},
+    {"motion_yposition",                 Block::MOTION_YPOSITION},
+    {"motion_yscroll",                   Block::NONE},
+    {"operator_add",                     Block::OPERATOR_ADD},
+    {"operator_and",                     Block::OPERATOR_AND},
+    {"operator_contains",                Block::OPERATOR_CONTAINS},
+    {"operator_divide",                  Block::OPERATOR_DIVIDE},
+    {"operator_equals",                  Block::OPERATOR_EQUALS},
+    {"operator_gt",                      Block::OPERATOR_GT},
+    {"operator_join",                    Block::OPERATOR_JOIN},
+    {"operator_length",                  Block::OPERATOR_LENGTH},
+    {"operator_letter_of",               Block::OPERATOR_LETTER_OF},
+    {"operator_lt",                      Block::OPERATOR_LT},
+    {"operator_mathop",                  Block::OPERATOR_MATHOP},
+    {"operator_mod",                     Block::OPERATOR_MOD},
+    {"operator_multiply",                Block::OPERATOR_MULTIPLY},
+    {"operator_not",                     Block::OPERATOR_NOT},
+    {"operator_or",                      Block::OPERATOR_OR},
+    {"operator_random",                  Block::OPERATOR_RANDOM},
+    {"operator_round",                   Block::OPERATOR_ROUND},
+    {"operator_subtract",                Block::OPERATOR_SUBTRACT},
+    {"pen_changePenColorParamBy",        Block::NONE},
+    {"pen_changePenHueBy",               Block::NONE},
+    {"pen_changePenShadeBy",             Block::NONE},
+    {"pen_changePenSizeBy",              Block::NONE},
+    {"pen_clear",                        Block::NONE},
+    {"pen_menu_colorParam",              Block::NONE},
+    {"pen_penDown",                      Block::NONE},
+    {"pen_penUp",                        Block::NONE},
+    {"pen_setPenColorParamTo",           Block::NONE},
+    {"pen_setPenColorToColor",           Block::NONE},
+    {"pen_setPenHueToNumber",            Block::NONE},
+    {"pen_setPenShadeToNumber",          Block::NONE},
+    {"pen_setPenSizeTo",                 Block::NONE},
+    {"pen_stamp",                        Block::NONE},
+    {"procedures_call",                  Block::PROCEDURES_CALL},
+    {"procedures_declaration",           Block::NONE},
+    {"procedures_definition",            Block::PROCEDURES_DEFINITION},
+    {"procedures_prototype",             Block::PROCEDURES_PROTOTYPE},
+    {"sensing_answer",                   Block::SENSING_ANSWER},
+    {"sensing_askandwait",               Block::SENSING_ASK_AND_WAIT},
+    {"sensing_coloristouchingcolor",     Block::NONE},
+    {"sensing_current",                  Block::SENSING_CURRENT},
+    {"sensing_dayssince2000",            Block::SENSING_DAYS_SINCE_2000},
+    {"sensing_distanceto",               Block::SENSING_DISTANCETO},
+    {"sensing_distancetomenu",           Block::SENSING_DISTANCETO_MENU},
+    {"sensing_keyoptions",               Block::SENSING_KEYOPTIONS},
+    {"sensing_keypressed",               Block::SENSING_KEYPRESSED},
+    {"sensing_loud",                     Block::NONE},
+    {"sensing_loudness",                 Block::NONE},
+    {"sensing_mousedown",                Block::SENSING_MOUSEDOWN},
+    {"sensing_mousex",                   Block::SENSING_MOUSEX},
+    {"sensing_mousey",                   Block::SENSING_MOUSEY},
+    {"sensing_of",                       Block::SENSING_OF},
+    {"sensing_of_object_menu",           Block::SENSING_OF_OBJECT_MENU},
+    {"sensing_resettimer",               Block::SENSING_RESETTIMER},
+    {"sensing_setdragmode",              Block::SENSING_SET_DRAG_MODE},
+    {"sensing_timer",                    Block::SENSING_TIMER},
+    {"sensing_touchingcolor",            Block::NONE},
+    {"sensing_touchingobject",           Block::SENSING_TOUCHINGOBJECT},
+    {"sensing_touchingobjectmenu",       Block::SENSING_TOUCHINGOBJECTMENU},
+    {"sensing_userid",                   Block::NONE},
+    {"sensing_username",                 Block::SENSING_USERNAME},
+    {"sound_beats_menu",                 Block::NONE},
+    {"sound_changeeffectby",             Block::SOUND_CHANGEEFFECTBY},
+    {"sound_changevolumetoby",           Block::SOUND_CHANGEVOLUMETOBY},
+    {"sound_cleareffects",               Block::SOUND_CLEAREFFECTS},
+    {"sound_effects_menu",               Block::NONE},
+    {"sound_play",                       Block::SOUND_PLAY},
+    {"sound_playuntildone",              Block::SOUND_PLAYUNTILDONE},
+    {"sound_seteffectto",                Block::SOUND_SETEFFECTTO},
+    {"sound_setvolumeto",                Block::SOUND_SETVOLUMETO},
+    {"sound_sounds_menu",                Block::SOUND_SOUNDS_MENU},
+    {"sound_stopallsounds",              Block::SOUND_STOPALLSOUNDS},
+    {"sound_volume",                     Block::SOUND_VOLUME},
+};
+static constexpr size_t opcodeNameCount = sizeof(opcodeNames) / sizeof(opcodeNames[0]);
+
+static constexpr bool opcodeNamesSorted(){
+    for(size_t i = 1; i < opcodeNameCount; i++){
+        if(!(opcodeNames[i - 1].name < opcodeNames[i].name)) return false;
+    }
+    return true;
+}
+static_assert(opcodeNamesSorted(), "opcodeNames has to stay sorted by name, with no duplicates");
+
+Block::opCode Block::stringToOpcode(std::string_view opCodeString){
+    size_t low = 0;
+    size_t high = opcodeNameCount;
+    while(low < high){
+        size_t middle = (low + high) / 2;
+        if(opcodeNames[middle].name < opCodeString) low = middle + 1;
+        else high = middle;
+    }
+    if(low < opcodeNameCount && opcodeNames[low].name == opCodeString) return opcodeNames[low].opcode;
+    std::cerr << "Unknown opcode: " << opCodeString << std::endl;
+    return NONE;
+}
+
 Value Block::getVariableValue(const std::string& variableId, Sprite* sprite) const {
-        // Fast variable lookup
-        auto it = sprite->variables.find(variableId);
-        if (it != sprite->variables.end()) {
-            return it->second.value;
-        }
-        
-        // Check global variables (stage sprite)
-        for (const auto& currentSprite : sprites) {
-            if (currentSprite->isStage) {
-                auto globalIt = currentSprite->variables.find(variableId);
-                if (globalIt != currentSprite->variables.end()) {
-                    return globalIt->second.value;
-                }
-            }
-        }
-        
-        return Value(0);
-    }
\ No newline at end of file
+        VariableRef variable = resolveVariable(variableId, sprite);
+        if (variable.scope == VariableRef::UNRESOLVED) return Value(0);
+        return variableValue(variable, sprite);
+    }
@@ -1,12 +1,22 @@
 #pragma once
 #include "value.hpp"
+#include "input.hpp"
+#include "spatialGrid.hpp"
+#include "collisionMask.hpp"
 #include <string>
+#include <string_view>
 #include <unordered_map>
 #include <nlohmann/json.hpp>
 #include <iostream>
 #include <chrono>
+#include <memory>
+#include <array>
+#include <deque>
+#include <cstdint>
 
 class Sprite;
+struct Block;
+struct CustomBlock;
 
 struct Variable {
     std::string id;
@@ -14,6 +24,31 @@ struct Variable {
     Value value;
 };
 
+// where a variable lives, resolved at load. LOCAL indexes the running sprite's (or clone's) own variables,
+// GLOBAL indexes the stage variables
+struct VariableRef {
+    enum Scope{
+        UNRESOLVED,
+        LOCAL,
+        GLOBAL
+    };
+
+    Scope scope = UNRESOLVED;
+    int slot = -1;
+};
+
+// same idea for lists, LOCAL indexes the running sprite's (or clone's) own lists
+struct ListRef {
+    enum Scope{
+        UNRESOLVED,
+        LOCAL,
+        GLOBAL
+    };
+
+    Scope scope = UNRESOLVED;
+    int slot = -1;
+};
+
 struct ParsedInput{
     enum InputType{
         LITERAL,
@@ -26,12 +61,32 @@ struct ParsedInput{
     Value literalValue;
     std::string variableId;
     std::string blockId;
+    Block* block = nullptr; // set by the linker, also for menu literals that name a shadow block
+    VariableRef variable; // set by the linker for VARIABLE inputs
+    ListRef list; // set by the linker for list reporters dropped into an input
 
     ParsedInput() : inputType(LITERAL), literalValue(Value(0)) {}
 
 };
 
 struct Block {
+    // inputs are stored in a small fixed array instead of a map. every input name gets a slot,
+    // numbered so that no opcode has two inputs on the same one.
+    enum InputSlot{
+        NUM = 0, NUM1 = 0, NUM2 = 1,
+        OPERAND = 0, OPERAND1 = 0, OPERAND2 = 1,
+        STRING1 = 0, STRING2 = 1, LETTER = 0, STRING = 1,
+        FROM = 0, TO = 1,
+        STEPS = 0, X = 0, Y = 1, DX = 0, DY = 0, DEGREES = 0, DIRECTION = 0, TOWARDS = 0, SECS = 2,
+        COSTUME = 0, BACKDROP = 0, SIZE = 0, CHANGE = 0, VALUE = 0,
+        SOUND_MENU = 0, VOLUME = 0,
+        CONDITION = 0, TIMES = 0, DURATION = 0, SUBSTACK = 1, SUBSTACK2 = 2, CLONE_OPTION = 0,
+        ITEM = 0, INDEX = 1,
+        KEY_OPTION = 0, OBJECT = 0, TOUCHINGOBJECTMENU = 0, DISTANCETOMENU = 0, QUESTION = 0,
+        BROADCAST_INPUT = 0, CUSTOM_BLOCK = 0,
+        INPUT_SLOTS = 3
+    };
+
     enum opCode{
         NONE,
         EVENT_WHENFLAGCLICKED,
@@ -154,167 +209,81 @@ struct Block {
         OPERATOR_OR,
         OPERATOR_NOT,
         OPERATOR_CONTAINS,
-        
-
 
+        OPCODE_COUNT // keep last, sizes the dispatch tables
+    };
 
+    // fields with a fixed set of choices, decoded by the linker so handlers don't compare strings
+    enum FieldOption {
+        NO_OPTION = -1,
+        // STOP_OPTION
+        STOP_ALL, STOP_THIS_SCRIPT, STOP_OTHER_SCRIPTS,
+        // OPERATOR of operator_mathop
+        MATH_ABS, MATH_FLOOR, MATH_CEILING, MATH_SQRT, MATH_SIN, MATH_COS, MATH_TAN,
+        MATH_ASIN, MATH_ACOS, MATH_ATAN, MATH_LN, MATH_LOG, MATH_E_POW, MATH_TEN_POW,
+        // FORWARD_BACKWARD, FRONT_BACK
+        LAYER_FORWARD, LAYER_BACKWARD, LAYER_FRONT, LAYER_BACK,
+        // EFFECT of the looks effect blocks
+        EFFECT_COLOR, EFFECT_FISHEYE, EFFECT_WHIRL, EFFECT_PIXELATE, EFFECT_MOSAIC, EFFECT_BRIGHTNESS, EFFECT_GHOST,
+        // NUMBER_NAME
+        NUMBER, NAME,
+        // DRAG_MODE
+        DRAGGABLE, NOT_DRAGGABLE,
+        // STYLE
+        STYLE_LEFT_RIGHT, STYLE_DONT_ROTATE, STYLE_ALL_AROUND,
+        // CURRENTMENU
+        CURRENT_YEAR, CURRENT_MONTH, CURRENT_DATE, CURRENT_DAY_OF_WEEK, CURRENT_HOUR, CURRENT_MINUTE, CURRENT_SECOND,
+        // PROPERTY of sensing_of. anything else is the name of one of the object's variables
+        PROPERTY_X, PROPERTY_Y, PROPERTY_DIRECTION, PROPERTY_COSTUME_NUMBER, PROPERTY_COSTUME_NAME,
+        PROPERTY_SIZE, PROPERTY_VOLUME, PROPERTY_TIMER,
+        // the object menus (TO, TOWARDS, DISTANCETOMENU, TOUCHINGOBJECTMENU, CLONE_OPTION). anything else is a sprite name
+        TARGET_RANDOM, TARGET_MOUSE, TARGET_EDGE, TARGET_MYSELF
     };
     
-    opCode stringToOpcode(std::string opCodeString){
-        if(opCodeString == "event_whenflagclicked")return EVENT_WHENFLAGCLICKED;
-        if(opCodeString == "event_whenbroadcastreceived")return EVENT_WHENBROADCASTRECEIVED;
-        if(opCodeString == "event_broadcastandwait") return EVENT_BROADCASTANDWAIT;
-        if(opCodeString == "event_broadcast")return EVENT_BROADCAST;
-        if(opCodeString == "event_whenkeypressed") return EVENT_WHEN_KEY_PRESSED;
-        if(opCodeString == "procedures_prototype")return PROCEDURES_PROTOTYPE;
-        if(opCodeString == "procedures_definition")return PROCEDURES_DEFINITION;
-        if(opCodeString == "procedures_call")return PROCEDURES_CALL;
-        if(opCodeString == "argument_reporter_string_number")return ARGUMENT_REPORTER_STRING_NUMBER;
-        if(opCodeString == "argument_reporter_boolean")return ARGUMENT_REPORTER_BOOLEAN;
-        if(opCodeString == "motion_xposition")return MOTION_XPOSITION;
-        if(opCodeString == "motion_yposition")return MOTION_YPOSITION;
-        if(opCodeString == "motion_direction")return MOTION_DIRECTION;
-        if(opCodeString == "motion_gotoxy")return MOTION_GOTOXY;
-        if(opCodeString == "motion_goto")return MOTION_GOTO;
-        if(opCodeString == "motion_goto_menu")return MOTION_GOTO_MENU;
-        if(opCodeString == "motion_movesteps")return MOTION_MOVE_STEPS;
-        if(opCodeString == "motion_pointtowards")return MOTION_POINT_TOWARD;
-        if(opCodeString == "motion_pointtowards_menu")return MOTION_POINT_TOWARD_MENU;
-        if(opCodeString == "motion_pointindirection")return MOTION_POINTINDIRECTION;
-        if(opCodeString == "motion_turnright")return MOTION_TURNRIGHT;
-        if(opCodeString == "motion_turnleft")return MOTION_TURNLEFT;
-        if(opCodeString == "motion_changexby")return MOTION_CHANGEXBY;
-        if(opCodeString == "motion_changeyby")return MOTION_CHANGEYBY;
-        if(opCodeString == "motion_setx")return MOTION_SETX;
-        if(opCodeString == "motion_sety")return MOTION_SETY;
-        if(opCodeString == "motion_setrotationstyle") return MOTION_SET_ROTATION_STYLE;
-        if(opCodeString == "motion_ifonedgebounce") return MOTION_IF_ON_EDGE_BOUNCE;
-        if(opCodeString == "motion_glideto") return MOTION_GLIDE_TO;
-        if(opCodeString == "motion_glideto_menu") return MOTION_GLIDE_TO_MENU;
-        if(opCodeString == "motion_glidesecstoxy") return MOTION_GLIDE_SECS_TO_XY;
-        if(opCodeString == "looks_size")return LOOKS_SIZE;
-        if(opCodeString == "looks_show")return LOOKS_SHOW;
-        if(opCodeString == "looks_hide")return LOOKS_HIDE;
-        if(opCodeString == "looks_switchcostumeto")return LOOKS_SWITCHCOSTUMETO;
-        if(opCodeString == "looks_costume")return LOOKS_COSTUME;
-        if(opCodeString == "looks_nextcostume")return LOOKS_NEXTCOSTUME;
-        if(opCodeString == "looks_switchbackdropto")return LOOKS_SWITCHBACKDROPTO;
-        if(opCodeString == "looks_backdrops")return LOOKS_BACKDROPS;
-        if(opCodeString == "looks_nextbackdrop")return LOOKS_NEXTBACKDROP;
-        if(opCodeString == "looks_backdropnumbername")return LOOKS_BACKDROPNUMBERNAME;
-        if(opCodeString == "looks_costumenumbername")return LOOKS_COSTUMENUMBERNAME;
-        if(opCodeString == "looks_changesizeby")return LOOKS_CHANGESIZEBY;
-        if(opCodeString == "looks_setsizeto")return LOOKS_SETSIZETO;
-        if(opCodeString == "looks_goforwardbackwardlayers")return LOOKS_GO_FORWARD_BACKWARD_LAYERS;
-        if(opCodeString == "looks_gotofrontback")return LOOKS_GO_TO_FRONT_BACK;
-        if(opCodeString == "looks_seteffectto") return LOOKS_SET_EFFECT_TO;
-        if(opCodeString == "looks_changeeffectby") return LOOKS_CHANGE_EFFECT_BY;
-        if(opCodeString == "looks_cleargraphiceffects") return LOOKS_CLEAR_GRAPHIC_EFFECTS;
-        if(opCodeString == "sound_volume")return SOUND_VOLUME;
-        if(opCodeString == "sound_playuntildone")return SOUND_PLAYUNTILDONE;
-        if(opCodeString == "sound_sounds_menu")return SOUND_SOUNDS_MENU;
-        if(opCodeString == "sound_play")return SOUND_PLAY;
-        if(opCodeString == "sound_stopallsounds")return SOUND_STOPALLSOUNDS;
-        if(opCodeString == "sound_changeeffectby")return SOUND_CHANGEEFFECTBY;
-        if(opCodeString == "sound_seteffectto")return SOUND_SETEFFECTTO;
-        if(opCodeString == "sound_cleareffects")return SOUND_CLEAREFFECTS;
-        if(opCodeString == "sound_changevolumetoby")return SOUND_CHANGEVOLUMETOBY;
-        if(opCodeString == "sound_setvolumeto")return SOUND_SETVOLUMETO;
-        if(opCodeString == "sensing_timer")return SENSING_TIMER;
-        if(opCodeString == "sensing_resettimer")return SENSING_RESETTIMER;
-        if(opCodeString == "control_wait_until")return CONTROL_WAIT_UNTIL;
-        if(opCodeString == "control_wait")return CONTROL_WAIT;
-        if(opCodeString == "control_if")return CONTROL_IF;
-        if(opCodeString == "control_if_else")return CONTROL_IF_ELSE;
-        if(opCodeString == "control_repeat_until")return CONTROL_REPEAT_UNTIL;
-        if(opCodeString == "control_while")return CONTROL_WHILE;
-        if(opCodeString == "control_forever")return CONTROL_FOREVER;
-        if(opCodeString == "control_repeat")return CONTROL_REPEAT;
-        if(opCodeString == "control_create_clone_of")return CONTROL_CREATE_CLONE_OF;
-        if(opCodeString == "control_create_clone_of_menu")return CONTROL_CREATE_CLONE_OF_MENU;
-        if(opCodeString == "control_start_as_clone")return CONTROL_START_AS_CLONE;
-        if(opCodeString == "control_delete_this_clone")return CONTROL_DELETE_THIS_CLONE;
-        if(opCodeString == "control_stop")return CONTROL_STOP;
-        if(opCodeString == "data_setvariableto")return DATA_SETVARIABLETO;
-        if(opCodeString == "data_changevariableby")return DATA_CHANGEVARIABLEBY;
-        if(opCodeString == "operator_add")return OPERATOR_ADD;
-        if(opCodeString == "operator_subtract")return OPERATOR_SUBTRACT;
-        if(opCodeString == "operator_multiply")return OPERATOR_MULTIPLY;
-        if(opCodeString == "operator_divide")return OPERATOR_DIVIDE;
-        if(opCodeString == "operator_random")return OPERATOR_RANDOM;
-        if(opCodeString == "operator_join")return OPERATOR_JOIN;
-        if(opCodeString == "operator_letter_of")return OPERATOR_LETTER_OF;
-        if(opCodeString == "operator_length")return OPERATOR_LENGTH;
-        if(opCodeString == "operator_mod")return OPERATOR_MOD;
-        if(opCodeString == "operator_round")return OPERATOR_ROUND;
-        if(opCodeString == "operator_mathop")return OPERATOR_MATHOP;
-        if(opCodeString == "data_itemoflist")return DATA_ITEMOFLIST;
-        if(opCodeString == "data_itemnumoflist")return DATA_ITEMNUMOFLIST;
-        if(opCodeString == "data_lengthoflist")return DATA_LENGTHOFLIST;
-        if(opCodeString == "data_addtolist")return DATA_ADD_TO_LIST;
-        if(opCodeString == "data_deleteoflist")return DATA_DELETE_OF_LIST;
-        if(opCodeString == "data_deletealloflist")return DATA_DELETE_ALL_OF_LIST;
-        if(opCodeString == "data_insertatlist")return DATA_INSERT_AT_LIST;
-        if(opCodeString == "data_replaceitemoflist")return DATA_REPLACE_ITEM_OF_LIST;
-        if(opCodeString == "data_listcontainsitem")return DATA_LIST_CONTAINS_ITEM;
-        if(opCodeString == "sensing_keypressed")return SENSING_KEYPRESSED;
-        if(opCodeString == "sensing_keyoptions")return SENSING_KEYOPTIONS;
-        if(opCodeString == "sensing_of")return SENSING_OF;
-        if(opCodeString == "sensing_of_object_menu")return SENSING_OF_OBJECT_MENU;
-        if(opCodeString == "sensing_touchingobject")return SENSING_TOUCHINGOBJECT;
-        if(opCodeString == "sensing_touchingobjectmenu")return SENSING_TOUCHINGOBJECTMENU;
-        if(opCodeString == "sensing_distanceto")return SENSING_DISTANCETO;
-        if(opCodeString == "sensing_distancetomenu")return SENSING_DISTANCETO_MENU;
-        if(opCodeString == "sensing_mousedown")return SENSING_MOUSEDOWN;
-        if(opCodeString == "sensing_mousex")return SENSING_MOUSEX;
-        if(opCodeString == "sensing_mousey")return SENSING_MOUSEY;
-        if(opCodeString == "sensing_dayssince2000") return SENSING_DAYS_SINCE_2000;
-        if(opCodeString == "sensing_current") return SENSING_CURRENT;
-        if(opCodeString == "sensing_askandwait") return SENSING_ASK_AND_WAIT;
-        if(opCodeString == "sensing_answer") return SENSING_ANSWER;
-        if(opCodeString == "sensing_username") return SENSING_USERNAME;
-        if(opCodeString == "sensing_setdragmode") return SENSING_SET_DRAG_MODE;
-        if(opCodeString == "operator_equals")return OPERATOR_EQUALS;
-        if(opCodeString == "operator_gt")return OPERATOR_GT;
-        if(opCodeString == "operator_lt")return OPERATOR_LT;
-        if(opCodeString == "operator_and")return OPERATOR_AND;
-        if(opCodeString == "operator_or")return OPERATOR_OR;
-        if(opCodeString == "operator_not")return OPERATOR_NOT;
-        if(opCodeString == "operator_contains")return OPERATOR_CONTAINS;
-        if(opCodeString == "sensing_username")return SENSING_USERNAME;
-        std::cerr << "Unknown opcode: " << opCodeString << std::endl;
-        return NONE;
-
-    }
-
+    // NONE for blocks that aren't supported yet, they're skipped when run
+    static opCode stringToOpcode(std::string_view opCodeString);
 
     std::string id;
     opCode opcode;
     std::string next;
-    Block* nextBlock;
+    Block* nextBlock = nullptr;
+    Block* parentBlock = nullptr;
+    int pc = -1; // index of this block's instruction in the sprite's program
     std::string parent;
-    std::string blockChainID;
-    std::map<std::string, ParsedInput> parsedInputs;
-    std::unordered_map<std::string, nlohmann::json> fields;
-    std::unordered_map<std::string, nlohmann::json> mutation;
+    ParsedInput inputs[INPUT_SLOTS];
+    VariableRef variable; // the VARIABLE field of the data blocks, set by the linker
+    ListRef list; // the LIST field of the list blocks, set by the linker
+    int broadcast = -1; // the interned BROADCAST_OPTION of a when I receive hat, set by the linker
+    int target = -1; // the interned sprite name an object menu picked, set by the linker
+    Input::Key key = Input::Key::NONE; // its KEY_OPTION field, set by the linker
+    std::vector<ParsedInput> arguments; // procedures_call only, in the custom block's argumentIds order
+    // scratch blocks have at most one field. its text is kept for fields that name something
+    // (a costume, a sprite, an argument...), fixed choices are decoded into option by the linker
+    std::string field;
+    FieldOption option = NO_OPTION;
+    std::string fieldId; // the id of a VARIABLE or LIST field, only until the linker resolved it
+    std::string proccode; // procedures_call only, until the linker found its custom block
+    const CustomBlock* procedure = nullptr; // procedures_call only, set by the linker
     bool shadow;
     bool topLevel;
-    std::string topLevelParentBlock;
+    Block* topLevelParentBlock = nullptr;
 
-/* variables that some blocks need*/
-    int repeatTimes = -1;
+private:
+    Value getVariableValue(const std::string& variableId, Sprite* sprite) const;
+
+};
+
+// what a running block remembers between frames. it lives in the frame of the thread running it,
+// so the same script can run in several clones at once
+struct BlockState {
+    bool started = false; // set up on the first run, cleared when the frame moves past the block
+    int repeatTimes = 0;
     double waitDuration;
     double glideStartX,glideStartY;
     double glideEndX,glideEndY;
     std::chrono::high_resolution_clock::time_point waitStartTime;
-    bool customBlockExecuted = false;
-    Block* customBlockPtr = nullptr;
     std::vector<std::pair<Block*, Sprite*>> broadcastsRun;
     std::string soundName; // For tracking sound playback in playUntilDone
-
-private:
-    Value getVariableValue(const std::string& variableId, Sprite* sprite) const;
-
 };
 
 struct CustomBlock{
@@ -325,7 +294,6 @@ struct CustomBlock{
     std::vector<std::string> argumentIds;
     std::vector<std::string> argumentNames;
     std::vector<std::string> argumentDefaults;
-    std::unordered_map<std::string,Value> argumentValues;
     bool runWithoutScreenRefresh;
 
 };
@@ -351,9 +319,9 @@ struct Costume{
     std::string name;
     std::string fullName;
     std::string dataFormat;
-    int bitmapResolution;
-    double rotationCenterX;
-    double rotationCenterY;
+    int bitmapResolution = 1;
+    double rotationCenterX = 0;
+    double rotationCenterY = 0;
 };
 
 struct Comment{
@@ -373,18 +341,123 @@ struct Broadcast{
     std::string name;
 };
 
-struct BlockHierarchyCache {
+// one step of a compiled script. operands (inputs and fields) are read from the block.
+struct Instruction {
+    Block::opCode opcode;
+    Block* block;
+    int next = -1;       // index of the following instruction, -1 ends the chain
+    int substack = -1;   // first instruction of SUBSTACK
+    int substack2 = -1;  // first instruction of SUBSTACK2
+};
+
+// a sprite as loaded, and the clones of it that are still alive
+struct SpriteEntry {
+    Sprite* original = nullptr;
+    std::vector<Sprite*> clones;
+    SpatialGrid grid; // the original and its clones by where they are
+};
+
+// what belongs to the stage instead of a single sprite: global variables, global lists and broadcasts
+struct GlobalScope {
+    std::vector<Variable> variables; // indexed by VariableRef::slot
+    std::unordered_map<std::string, int> variableSlots; // variable id -> slot
+    std::vector<List> lists; // indexed by ListRef::slot
+    std::unordered_map<std::string, int> listSlots; // list id -> slot
+    std::unordered_map<std::string, Broadcast> broadcasts;
+    std::unordered_map<std::string, int> broadcastIds; // message name -> interned id
+    // hats of every sprite and clone, so starting scripts only touches the ones that match
+    std::vector<std::vector<std::pair<Block*, Sprite*>>> receivers; // when I receive, by message id
+    std::vector<std::pair<Block*, Sprite*>> flagHats; // when flag clicked
+    std::array<std::vector<std::pair<Block*, Sprite*>>, Input::keyCount> keyHats; // when key pressed, by key
+    // sprites by name, so blocks naming one don't have to scan every sprite
+    std::vector<SpriteEntry> spriteEntries; // by interned name
+    std::unordered_map<std::string, int> spriteIds; // sprite name -> interned id
+    std::vector<Sprite*> movedSprites; // to be refiled in their grid before the next touching check
+};
+
+// broadcasts waiting for their receivers to be started, as interned message ids. a message has
+// at most one slot in the ring, so sized to the number of messages it can't overflow
+struct BroadcastQueue {
+    enum Status : unsigned char { IDLE, WAITING, CANCELLED };
+
+    std::vector<int> ring;
+    std::vector<Status> status; // by message id
+    size_t head = 0;
+    size_t count = 0;
+
+    void reset(size_t messages){
+        ring.assign(messages, -1);
+        status.assign(messages, IDLE);
+        head = 0;
+        count = 0;
+        maxDepth = 0;
+    }
+
+    // a message that's already waiting isn't queued twice
+    void push(int message){
+        if(message < 0 || message >= static_cast<int>(status.size()) || status[message] == WAITING) return;
+        if(status[message] == CANCELLED){
+            // still has its slot
+            status[message] = WAITING;
+            return;
+        }
+        status[message] = WAITING;
+        ring[(head + count) % ring.size()] = message;
+        count++;
+        if(count > maxDepth) maxDepth = count;
+    }
+
+    // -1 once it's empty
+    int pop(){
+        while(count > 0){
+            int message = ring[head];
+            head = (head + 1) % ring.size();
+            count--;
+            Status previous = status[message];
+            status[message] = IDLE;
+            if(previous == WAITING) return message;
+        }
+        return -1;
+    }
 
-    std::unordered_map<std::string, std::string> blockToParentConditional;
+    // the message was started some other way, it doesn't need to wait anymore
+    void cancel(int message){
+        if(message >= 0 && message < static_cast<int>(status.size()) && status[message] == WAITING) status[message] = CANCELLED;
+    }
 
-    std::unordered_map<std::string, std::string> blockToTopLevel;
+    bool empty() const {
+        return count == 0;
+    }
 
-    bool isCacheBuilt = false;
+    // the most messages that were waiting at once since the load or the last resetMaxDepth
+    size_t getMaxDepth() const {
+        return maxDepth;
+    }
+    // starts a new high-water mark from what's waiting now
+    void resetMaxDepth(){
+        maxDepth = count;
+    }
+
+private:
+    size_t maxDepth = 0;
 };
 
-struct BlockChain {
-    std::vector<Block*> blockChain;
-    std::vector<std::string> blocksToRepeat;
+// everything a sprite loads that doesn't change while it runs. clones point at their
+// original's copy instead of duplicating it
+struct SharedSpriteData {
+    std::unordered_map<std::string, int> variableSlots; // variable id -> slot
+    std::unordered_map<std::string, int> listSlots; // list id -> slot
+    std::unordered_map<std::string, Block> blocks;
+    std::unordered_map<std::string, Sound> sounds;
+    std::vector<Costume> costumes;
+    std::unordered_map<std::string, Comment> comments;
+    std::unordered_map<std::string, CustomBlock> customBlocks;
+    std::vector<Instruction> program;
+    // its hats by event, set by the linker
+    std::vector<Block*> broadcastHats;
+    std::vector<Block*> flagHats;
+    std::vector<Block*> cloneHats;
+    std::vector<Block*> keyHats;
 };
 
 class Sprite {
@@ -423,18 +496,133 @@ class Sprite {
         int spriteHeight;
     
 
-        std::unordered_map<std::string, Variable> variables;
-        std::unordered_map<std::string, Block> blocks;
-        std::unordered_map<std::string, List> lists;
-        std::unordered_map<std::string, Sound> sounds;
-        std::vector<Costume> costumes;
-        std::unordered_map<std::string, Comment> comments;
-        std::unordered_map<std::string, Broadcast> broadcasts;
-        std::unordered_map<std::string, CustomBlock> customBlocks;
-        std::unordered_map<std::string,BlockChain> blockChains;
-        BlockHierarchyCache blockCache;
+        std::vector<Variable> variables; // indexed by VariableRef::slot
+        std::vector<List> lists; // indexed by ListRef::slot
+        std::shared_ptr<SharedSpriteData> shared; // the same for a sprite and all its clones
+        int nameId = -1; // its name interned in globals.spriteIds, the same for its clones
+        uint32_t generation = 0; // bumped every time its clone pool slot is released
+        GridSlot gridSlot; // where it's filed in its SpriteEntry's grid
+        StageMask stageMask; // its costume's pixels as they are on the stage, made on the first touching check
     
         void loadFromJson(const nlohmann::json& json);
         void runScript(const std::string& blockId);
         void executeBlock(const Block& block);
-    };
\ No newline at end of file
+    };
+
+// where clones live. slots are made the first time they're needed, up to the clone limit, and
+// go back on the free list when their clone is deleted. a deque, so growing it doesn't move
+// clones that are alive. a released slot bumps its generation, so anything that kept
+// a pointer to the old clone can tell it's gone
+struct ClonePool {
+    std::deque<Sprite> slots;
+    std::vector<Sprite*> freeSlots;
+    std::vector<Sprite*> deleted; // clones deleted this tick, released once every thread had its turn
+    size_t limit = 300;
+    size_t live = 0;
+
+    void reset(size_t cloneLimit){
+        slots.clear();
+        freeSlots.clear();
+        deleted.clear();
+        limit = cloneLimit;
+        live = 0;
+    }
+
+    // a copy of the sprite in a free slot, nullptr once the limit is reached. the copy leaves its stage mask behind
+    Sprite* acquire(const Sprite& original){
+        Sprite* clone;
+        if(!freeSlots.empty()){
+            clone = freeSlots.back();
+            freeSlots.pop_back();
+        }
+        else if(slots.size() < limit){
+            slots.emplace_back();
+            clone = &slots.back();
+        }
+        else return nullptr;
+        uint32_t generation = clone->generation;
+        *clone = original;
+        clone->generation = generation;
+        clone->isClone = true;
+        clone->isStage = false;
+        clone->toDelete = false;
+        clone->isDeleted = false;
+        live++;
+        return clone;
+    }
+
+    void release(Sprite* clone){
+        clone->isDeleted = true;
+        clone->generation++;
+        // don't keep the clone's variables and lists alive until the slot is reused
+        clone->variables.clear();
+        clone->lists.clear();
+        freeSlots.push_back(clone);
+        live--;
+    }
+};
+
+// one level of a running script: its top level chain, a substack or a custom block's definition
+struct Frame {
+    int pc = -1; // the instruction this frame is at, -1 once it ran off the end
+    bool isLoop = false; // the block that started this frame runs again when it ends
+    bool warp = false; // run without screen refresh, loops and waits don't yield
+    BlockState state; // of the block at pc
+    const CustomBlock* procedure = nullptr; // set on the frame running a custom block's definition
+    std::vector<Value> arguments; // that custom block's argument values, in argumentIds order
+};
+
+// one running instance of a script. the frames are its call stack, the top one is running
+struct Thread {
+    Sprite* sprite;
+    uint32_t generation = 0; // the sprite's when the thread started, it's stale once they differ
+    Block* topBlock;
+    std::vector<Frame> frames;
+    bool restartPending = false;
+    bool warpTimerRunning = false; // this turn has run warp frames since warpStart
+    std::chrono::high_resolution_clock::time_point warpStart;
+
+    bool isDone() const {
+        return frames.empty();
+    }
+
+    bool isStale() const {
+        return sprite->generation != generation;
+    }
+
+    BlockState& state(){
+        return frames.back().state;
+    }
+
+    // pushes a frame starting at pc. it keeps the warp of the frame that started it
+    Frame& startBranch(int pc, bool isLoop){
+        bool warp = !frames.empty() && frames.back().warp;
+        frames.emplace_back();
+        Frame& frame = frames.back();
+        frame.pc = pc;
+        frame.isLoop = isLoop;
+        frame.warp = warp;
+        return frame;
+    }
+
+    void restart(){
+        frames.clear();
+        startBranch(topBlock->pc, false);
+    }
+
+    void stop(){
+        frames.clear();
+    }
+
+    // "stop this script" in a custom block only returns from it: the frames it pushed are dropped
+    // and its own frame is left ended, so the caller carries on after the call. false outside a custom block
+    bool returnFromProcedure(){
+        for(size_t i = frames.size(); i-- > 0;){
+            if(frames[i].procedure == nullptr) continue;
+            frames.resize(i + 1);
+            frames.back().pc = -1;
+            return true;
+        }
+        return false;
+    }
+};
@@ -5,33 +5,45 @@
 #include "math.hpp"
 #include <nlohmann/json.hpp>
 
-enum class ValueType{
+enum class ValueType : unsigned char{
     INTEGER,
     DOUBLE,
-    STRING
+    STRING,
+    BOOLEAN
 };
 
 class Value{
 private:
+    // strings are immutable and shared between copies, so copying a Value never copies the text.
+    // the count isn't atomic, values only live on the interpreter thread
+    struct SharedString{
+        std::string text;
+        int refs;
+        // the text read as a number, parsed the first time anyone asks
+        enum Numeric : signed char { UNKNOWN, NOT_A_NUMBER, NUMBER };
+        mutable Numeric numeric = UNKNOWN;
+        mutable double number = 0.0;
+    };
+
+    // only for STRING values
+    bool parseString() const {
+        if (stringValue->numeric == SharedString::UNKNOWN) {
+            stringValue->numeric = Math::parseNumber(stringValue->text, &stringValue->number) ? SharedString::NUMBER : SharedString::NOT_A_NUMBER;
+        }
+        return stringValue->numeric == SharedString::NUMBER;
+    }
+
     ValueType type;
     union{
         int intValue;
         double doubleValue;
-        std::string* stringValue;
+        bool boolValue;
+        SharedString* stringValue;
     };
-public:
-    // constructors
-    Value() : type(ValueType::INTEGER), intValue(0) {}
-
-    explicit Value(int val) : type(ValueType::INTEGER), intValue(val) {}
 
-    explicit Value(double val) : type(ValueType::DOUBLE), doubleValue(val) {}
-
-    explicit Value(const std::string& val) : type(ValueType::STRING) {
-        stringValue = new std::string(val);
-    }
-    // copy operator
-    Value(const Value& other) : type(other.type){
+    // takes over other's payload without touching reference counts
+    void take(const Value& other){
+        type = other.type;
         switch(type){
             case ValueType::INTEGER:
                 intValue = other.intValue;
@@ -39,46 +51,73 @@ public:
             case ValueType::DOUBLE:
                 doubleValue = other.doubleValue;
                 break;
+            case ValueType::BOOLEAN:
+                boolValue = other.boolValue;
+                break;
             case ValueType::STRING:
-                stringValue = new std::string(*other.stringValue);
+                stringValue = other.stringValue;
                 break;
         }
     }
+    void retain() const {
+        if (type == ValueType::STRING) stringValue->refs++;
+    }
+    void release() {
+        if (type == ValueType::STRING && --stringValue->refs == 0) delete stringValue;
+    }
+public:
+    // constructors
+    Value() : type(ValueType::INTEGER), intValue(0) {}
+
+    explicit Value(int val) : type(ValueType::INTEGER), intValue(val) {}
+
+    explicit Value(double val) : type(ValueType::DOUBLE), doubleValue(val) {}
+
+    explicit Value(bool val) : type(ValueType::BOOLEAN), boolValue(val) {}
+
+    explicit Value(std::string val) : type(ValueType::STRING) {
+        stringValue = new SharedString{std::move(val), 1};
+    }
+    // (without this a string literal would pick the bool constructor)
+    explicit Value(const char* val) : Value(std::string(val)) {}
+
+    // copy operator
+    Value(const Value& other){
+        take(other);
+        retain();
+    }
+    Value(Value&& other) noexcept {
+        take(other);
+        other.type = ValueType::INTEGER;
+        other.intValue = 0;
+    }
     // Assignment operator
     Value& operator=(const Value& other){
+        other.retain(); // first, in case both share the string
+        release();
+        take(other);
+        return *this;
+    }
+    Value& operator=(Value&& other) noexcept {
         if(this != &other){
-            if(type == ValueType::STRING){
-                delete stringValue;
-            }
-            // copy new value
-            type = other.type;
-            switch(type){
-                case ValueType::INTEGER:
-                    intValue = other.intValue;
-                    break;
-                case ValueType::DOUBLE:
-                    doubleValue = other.doubleValue;
-                    break;
-                case ValueType::STRING:
-                    stringValue = new std::string(*other.stringValue);
-                    break;
-            }
+            release();
+            take(other);
+            other.type = ValueType::INTEGER;
+            other.intValue = 0;
         }
         return *this;
     }
     // destructor
     ~Value() {
-        if (type == ValueType::STRING) {
-            delete stringValue;
-        }
+        release();
     }
     // type checks
     bool isInteger() const { return type == ValueType::INTEGER; }
     bool isDouble() const { return type == ValueType::DOUBLE; }
     bool isString() const { return type == ValueType::STRING; }
+    bool isBoolean() const { return type == ValueType::BOOLEAN; }
     bool isNumeric() const { 
-        return type == ValueType::INTEGER || type == ValueType::DOUBLE ||
-               (type == ValueType::STRING && Math::isNumber(*stringValue));
+        return type != ValueType::STRING || parseString();
     }
 
     double asDouble() const {
@@ -87,8 +126,10 @@ public:
                 return static_cast<double>(intValue);
             case ValueType::DOUBLE:
                 return doubleValue;
+            case ValueType::BOOLEAN:
+                return boolValue ? 1.0 : 0.0;
             case ValueType::STRING:
-                return Math::isNumber(*stringValue) ? std:: stod(*stringValue) : 0.0;
+                return parseString() ? stringValue->number : 0.0;
         }
         return 0.0;
     }
@@ -99,10 +140,11 @@ public:
                 return intValue;
             case ValueType::DOUBLE:
                 return static_cast<int>(std::round(doubleValue));
+            case ValueType::BOOLEAN:
+                return boolValue ? 1 : 0;
             case ValueType::STRING:
-                if(Math::isNumber(*stringValue)){
-                    double d = std::stod(*stringValue);
-                    return static_cast<int>(std::round(d));
+                if(parseString()){
+                    return static_cast<int>(std::round(stringValue->number));
                 }
         }
         return 0;
@@ -119,8 +161,10 @@ public:
                 }
                 return std::to_string(doubleValue);
             }
+            case ValueType::BOOLEAN:
+                return boolValue ? "true" : "false";
             case ValueType::STRING:
-                return *stringValue;
+                return stringValue->text;
         }
         return "";
     }
@@ -174,9 +218,14 @@ public:
             switch(type) {
                 case ValueType::INTEGER: return intValue == other.intValue;
                 case ValueType::DOUBLE: return doubleValue == other.doubleValue;
-                case ValueType::STRING: return *stringValue == *other.stringValue;
+                case ValueType::BOOLEAN: return boolValue == other.boolValue;
+                case ValueType::STRING: return stringValue == other.stringValue || stringValue->text == other.stringValue->text;
             }
         }
+        // booleans compare as 1/0 against numbers, so true still equals the 1 it used to load as
+        if ((isBoolean() || other.isBoolean()) && isNumeric() && other.isNumeric()) {
+            return asDouble() == other.asDouble();
+        }
         // Different types - compare as strings (Scratch behavior)
         return asString() == other.asString();
     }
@@ -205,8 +254,9 @@ static Value fromJson(const nlohmann::json& jsonVal){
     } else if(jsonVal.is_string()){
         std::string strVal = jsonVal.get<std::string>();
 
-        if(Math::isNumber(strVal)){
-            double numVal = std::stod(strVal);
+        // numeric strings are stored as numbers up front
+        double numVal;
+        if(Math::parseNumber(strVal, &numVal)){
             if(std::floor(numVal) == numVal){
                 return Value(static_cast<int>(numVal));
             }
@@ -214,7 +264,7 @@ static Value fromJson(const nlohmann::json& jsonVal){
         }
         return Value(strVal);
     } else if(jsonVal.is_boolean()){
-        return Value(jsonVal.get<bool>() ? 1 : 0);
+        return Value(jsonVal.get<bool>());
     } else if(jsonVal.is_array()){
         if(jsonVal.size() > 1) {
             return fromJson(jsonVal[1]);
@@ -227,4 +277,6 @@ static Value fromJson(const nlohmann::json& jsonVal){
     ValueType getType() const { return type; }
 
 
-};
\ No newline at end of file
+};
+
+static_assert(sizeof(Value) <= 16, "Value should stay two words");
\ No newline at end of file
@@ -3,6 +3,7 @@
 #include "render.hpp"
 #include <iostream>
 #include "../scratch/unzip.hpp"
+#include "../scratch/collisionMask.hpp"
 #define NANOSVG_IMPLEMENTATION
 #include "nanosvg.h"
 #define NANOSVGRAST_IMPLEMENTATION
@@ -11,6 +12,16 @@
 std::vector<Image::ImageRGBA> Image::imageRGBAS;
 std::unordered_map<std::string,SDL_Image*> images;
 
+// keeps the surface's alpha as the costume's collision mask
+static void storeSurfaceMask(const std::string& costumeId, SDL_Surface* surface){
+    SDL_Surface* rgba = SDL_ConvertSurfaceFormat(surface, SDL_PIXELFORMAT_RGBA32, 0);
+    if (!rgba) return;
+    SDL_LockSurface(rgba);
+    storeCollisionMask(costumeId, (const unsigned char*)rgba->pixels, rgba->w, rgba->h, rgba->pitch);
+    SDL_UnlockSurface(rgba);
+    SDL_FreeSurface(rgba);
+}
+
 void Image::loadImages(mz_zip_archive *zip){
     std::cout << "Loading images..." << std::endl;
     int file_count = (int)mz_zip_reader_get_num_files(zip);
@@ -64,6 +75,7 @@ void Image::loadImages(mz_zip_archive *zip){
                             
                             // Rasterize SVG to RGBA
                             nsvgRasterize(rast, svg_image, 0, 0, scale, rgba_data, width, height, width * 4);
+                            storeCollisionMask(zipFileName.substr(0, zipFileName.find_last_of('.')), rgba_data, width, height, width * 4, scale);
                             
                             // Create SDL surface from RGBA data
                             surface = SDL_CreateRGBSurfaceFrom(rgba_data, width, height, 32, width * 4,
@@ -88,6 +100,7 @@ void Image::loadImages(mz_zip_archive *zip){
 
                 surface = IMG_Load_RW(rw, 0);
                 SDL_RWclose(rw);
+                if (surface) storeSurfaceMask(zipFileName.substr(0, zipFileName.find_last_of('.')), surface);
             }
             
             mz_free(file_data);
@@ -160,6 +173,7 @@ void Image::loadImageFromFile(std::string filePath){
                         
                         // Rasterize SVG to RGBA
                         nsvgRasterize(rast, svg_image, 0, 0, scale, rgba_data, width, height, width * 4);
+                        storeCollisionMask(filePath, rgba_data, width, height, width * 4, scale);
                         
                         // Create SDL surface from RGBA data
                         SDL_Surface* surface = SDL_CreateRGBSurfaceFrom(rgba_data, width, height, 32, width * 4,
@@ -227,6 +241,7 @@ SDL_Image::SDL_Image(std::string filePath){
         std::cout << "Error loading image: " << IMG_GetError();
         return;
     }
+    storeSurfaceMask(filePath, spriteSurface);
     spriteTexture = SDL_CreateTextureFromSurface(renderer, spriteSurface);
     if (spriteTexture == NULL) {
         std::cout << "Error creating texture";
@@ -1,39 +1,39 @@
 #include "../scratch/input.hpp"
+#include "../scratch/blockExecutor.hpp"
 #include <SDL2/SDL.h>
-#include <algorithm>
+#include <utility>
 #include "render.hpp"
 
 Input::Mouse Input::mousePointer;
 
 
-std::vector<std::string> Input::inputButtons;
+// scratch's keys that aren't a letter or a digit, and their scancodes
+static const std::pair<SDL_Scancode, Input::Key> otherKeys[] = {
+    {SDL_SCANCODE_SPACE, Input::Key::SPACE},
+    {SDL_SCANCODE_UP, Input::Key::UP_ARROW},
+    {SDL_SCANCODE_DOWN, Input::Key::DOWN_ARROW},
+    {SDL_SCANCODE_LEFT, Input::Key::LEFT_ARROW},
+    {SDL_SCANCODE_RIGHT, Input::Key::RIGHT_ARROW},
+};
 
 void Input::getInput(){
-inputButtons.clear();
 mousePointer.isPressed = false;
 
 const Uint8* keyStates = SDL_GetKeyboardState(NULL);
-bool anyKeyPressed = false;
+KeySet held;
 
- for (int scancode = 0; scancode < SDL_NUM_SCANCODES; ++scancode) {
-        if (keyStates[scancode]) {
-            const char* name = SDL_GetScancodeName(static_cast<SDL_Scancode>(scancode));
-            if (name && name[0] != '\0') {
-                std::string keyName(name);
-                std::transform(keyName.begin(), keyName.end(), keyName.begin(), ::tolower);
-
-                if (keyName == "up") keyName = "up arrow";
-                else if (keyName == "down") keyName = "down arrow";
-                else if (keyName == "left") keyName = "left arrow";
-                else if (keyName == "right") keyName = "right arrow";
-
-
-                inputButtons.push_back(keyName);
-                anyKeyPressed = true;
-            }
-        }
+    // letters and digits are in order in both SDL's scancodes and Key (SDL puts 0 after 9)
+    for (int i = 0; i < 26; i++) {
+        if (keyStates[SDL_SCANCODE_A + i]) held.set(static_cast<int>(Key::A) + i);
+    }
+    for (int i = 0; i < 10; i++) {
+        if (keyStates[SDL_SCANCODE_1 + i]) held.set(static_cast<int>(Key::DIGIT_0) + (i + 1) % 10);
+    }
+    for (const auto& [scancode, key] : otherKeys) {
+        if (keyStates[scancode]) held.set(static_cast<int>(key));
     }
-    if(anyKeyPressed) inputButtons.push_back("any");
+    setKeys(held);
+    BlockExecutor::runKeyPressedHats(keysPressed);
 
     SDL_GetMouseState(&mousePointer.x,&mousePointer.y);
     mousePointer.x -= windowWidth / 2;
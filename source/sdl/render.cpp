@@ -1,6 +1,7 @@
 #include "../scratch/render.hpp"
 #include "render.hpp"
 #include "interpret.hpp"
+#include "../scratch/collisionMask.hpp"
 int windowWidth = 480;
 int windowHeight = 360;
 SDL_Window* window = nullptr;
@@ -20,6 +21,7 @@ void Render::deInit(){
     SDL_DestroyWindow(window);
     IMG_Quit();
     SDL_Quit();
+    clearCollisionMasks();
 }
 void Render::renderSprites(){
     SDL_GetWindowSizeInPixels(window,&windowWidth,&windowHeight);
@@ -45,7 +47,7 @@ void Render::renderSprites(){
         if(!currentSprite->visible) continue;
 
         bool legacyDrawing = false;
-        auto imgFind = images.find(currentSprite->costumes[currentSprite->currentCostume].id); // long ahh line
+        auto imgFind = images.find(currentSprite->shared->costumes[currentSprite->currentCostume].id); // long ahh line
         if(imgFind == images.end()){
             legacyDrawing = true;
         }
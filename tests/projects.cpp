@@ -0,0 +1,370 @@
+#include "projectBuilder.hpp"
+#include "interpret.hpp"
+#include "blockExecutor.hpp"
+#include "input.hpp"
+#include <cstdio>
+#include <functional>
+
+// runs small projects on the headless platform and checks the variables they leave behind
+
+static int failures = 0;
+
+static void expect(const char* check, const char* variable, const Value& expected) {
+    Value actual = Headless::globalVariable(variable);
+    if (actual == expected) return;
+    printf("FAIL %s: %s is %s, expected %s\n", check, variable, actual.asString().c_str(), expected.asString().c_str());
+    failures++;
+}
+
+// builds a project from the stage and one sprite, runs it until it's done (or for ticks) and unloads it after the checks
+static void check(const char* name, const std::function<void(TargetBuilder& stage, TargetBuilder& sprite)>& build,
+                  const std::function<void()>& verify, int ticks = 1000) {
+    TargetBuilder stage("Stage", true);
+    TargetBuilder sprite("Sprite1");
+    build(stage, sprite);
+    Headless::start(buildProject({&stage, &sprite}));
+    // there are no images to size the sprites by
+    for (Sprite* loaded : sprites) loaded->spriteWidth = loaded->spriteHeight = 16;
+    Headless::run(ticks);
+    int before = failures;
+    verify();
+    Headless::stop();
+    printf("%s %s\n", failures == before ? "PASS" : "FAIL", name);
+}
+
+// a frame with these keys held, the way the platforms' getInput hands them over
+static void tickWithKeys(Input::KeySet held) {
+    Input::setKeys(held);
+    BlockExecutor::runKeyPressedHats(Input::keysPressed);
+    Headless::run(1);
+}
+
+// one tick whether or not a script is running, so clones deleted outside of one are released
+static void tick() {
+    BlockExecutor::startFrame();
+    BlockExecutor::runRepeatBlocks();
+}
+
+// how many scripts wait on the hats of this sprite
+static size_t registeredHats(Sprite* sprite) {
+    size_t count = 0;
+    auto countIn = [&](const std::vector<std::pair<Block*, Sprite*>>& hats) {
+        for (const auto& [hat, hatSprite] : hats) count += hatSprite == sprite;
+    };
+    countIn(globals.flagHats);
+    for (const auto& hats : globals.receivers) countIn(hats);
+    for (const auto& hats : globals.keyHats) countIn(hats);
+    return count;
+}
+
+int main() {
+    check("stop this script ends the script", [](TargetBuilder& stage, TargetBuilder& sprite) {
+        BuiltVariable a = stage.addVariable("a");
+        sprite.script({sprite.whenFlagClicked(), sprite.setVariable(a, number(1)), sprite.stopThisScript(), sprite.setVariable(a, number(99))});
+    }, [] {
+        expect("top level", "a", Value(1));
+    });
+
+    check("stop this script returns from a custom block", [](TargetBuilder& stage, TargetBuilder& sprite) {
+        BuiltVariable a = stage.addVariable("a");
+        BuiltVariable b = stage.addVariable("b");
+        sprite.script({sprite.defineProcedure("finish", false), sprite.setVariable(a, number(1)), sprite.stopThisScript(), sprite.setVariable(a, number(99))});
+        sprite.script({sprite.whenFlagClicked(), sprite.callProcedure("finish", false), sprite.setVariable(b, number(2))});
+    }, [] {
+        expect("custom block", "a", Value(1));
+        expect("caller", "b", Value(2));
+    });
+
+    check("stop this script leaves a loop in a custom block", [](TargetBuilder& stage, TargetBuilder& sprite) {
+        BuiltVariable a = stage.addVariable("a");
+        BuiltVariable b = stage.addVariable("b");
+        for (bool warp : {false, true}) {
+            std::string proccode = warp ? "count fast" : "count";
+            std::string reachedThree = sprite.equals(variable(a), number(3));
+            std::string body = sprite.stack({sprite.changeVariable(a, number(1)), sprite.ifThen(reachedThree, sprite.stopThisScript())});
+            sprite.script({sprite.defineProcedure(proccode, warp), sprite.repeat(number(10), body)});
+        }
+        sprite.script({sprite.whenFlagClicked(), sprite.callProcedure("count", false), sprite.changeVariable(b, number(1)),
+                       sprite.setVariable(a, number(0)), sprite.callProcedure("count fast", true), sprite.changeVariable(b, number(1))});
+    }, [] {
+        expect("custom block", "a", Value(3));
+        expect("caller", "b", Value(2));
+    });
+
+    check("stop this script only returns from the innermost custom block", [](TargetBuilder& stage, TargetBuilder& sprite) {
+        BuiltVariable a = stage.addVariable("a");
+        BuiltVariable b = stage.addVariable("b");
+        sprite.script({sprite.defineProcedure("inner", false), sprite.stopThisScript(), sprite.setVariable(a, number(99))});
+        sprite.script({sprite.defineProcedure("outer", false), sprite.callProcedure("inner", false), sprite.setVariable(a, number(1))});
+        sprite.script({sprite.whenFlagClicked(), sprite.callProcedure("outer", false), sprite.setVariable(b, number(2))});
+    }, [] {
+        expect("outer custom block", "a", Value(1));
+        expect("caller", "b", Value(2));
+    });
+
+    check("constant operators fold to their value", [](TargetBuilder& stage, TargetBuilder& sprite) {
+        BuiltVariable a = stage.addVariable("a");
+        BuiltVariable b = stage.addVariable("b");
+        std::string product = sprite.block("operator_multiply", {{"NUM1", number(2)}, {"NUM2", number(3)}});
+        std::string sum = sprite.block("operator_add", {{"NUM1", number(1)}, {"NUM2", reporter(product)}});
+        std::string joined = sprite.block("operator_join", {{"STRING1", text("a")}, {"STRING2", text("b")}});
+        sprite.script({sprite.whenFlagClicked(), sprite.setVariable(a, reporter(sum)), sprite.setVariable(b, reporter(joined))});
+    }, [] {
+        expect("nested operators", "a", Value(7));
+        expect("join", "b", Value(std::string("ab")));
+    });
+
+    check("reporters in shared input slots aren't compiled as substacks", [](TargetBuilder& stage, TargetBuilder& sprite) {
+        BuiltVariable a = stage.addVariable("a");
+        BuiltVariable v = stage.addVariable("v", 3);
+        // Y shares its slot with SUBSTACK, SECS with SUBSTACK2
+        std::string product = sprite.block("operator_multiply", {{"NUM1", variable(v)}, {"NUM2", number(2)}});
+        std::string sum = sprite.block("operator_add", {{"NUM1", variable(v)}, {"NUM2", number(1)}});
+        std::string glide = sprite.block("motion_glidesecstoxy", {{"SECS", number(0)}, {"X", number(0)}, {"Y", reporter(sum)}});
+        sprite.script({sprite.whenFlagClicked(), sprite.block("motion_gotoxy", {{"X", number(0)}, {"Y", reporter(product)}}), glide,
+                       sprite.setVariable(a, reporter(product))});
+    }, [] {
+        expect("reporter after the motion blocks", "a", Value(6));
+        size_t instructions = findOriginal(findSpriteId("Sprite1"))->shared->program.size();
+        if (instructions != 4) {
+            printf("FAIL program: %zu instructions, expected 4\n", instructions);
+            failures++;
+        }
+    });
+
+    check("booleans equal their number", [](TargetBuilder& stage, TargetBuilder& sprite) {
+        BuiltVariable a = stage.addVariable("a");
+        BuiltVariable b = stage.addVariable("b");
+        BuiltVariable flags = stage.addList("flags", {true});
+        auto contains = [&](const BuiltInput& item) {
+            return sprite.block("data_listcontainsitem", {{"ITEM", item}}, {{"LIST", {flags.name, flags.id}}});
+        };
+        sprite.script({sprite.whenFlagClicked(), sprite.setVariable(a, reporter(contains(number(1)))),
+                       sprite.setVariable(b, reporter(contains(text("true"))))});
+    }, [] {
+        expect("loaded true contains 1", "a", Value(true));
+        expect("loaded true contains \"true\"", "b", Value(true));
+        if (!(Value(true) == Value(1)) || !(Value(0.0) == Value(false)) || Value(true) == Value(2)) {
+            printf("FAIL Value: booleans and numbers compare wrong\n");
+            failures++;
+        }
+    });
+
+    check("a warp loop yields once its time budget is used", [](TargetBuilder& stage, TargetBuilder& sprite) {
+        stage.addComment("{\"warpTime\": 5}");
+        BuiltVariable a = stage.addVariable("a");
+        sprite.script({sprite.defineProcedure("spin", true), sprite.repeat(number(100000000), sprite.changeVariable(a, number(1)))});
+        sprite.script({sprite.whenFlagClicked(), sprite.callProcedure("spin", true)});
+    }, [] {
+        if (BlockExecutor::threads.empty() || warpTimeUsed < 5 || warpTimeUsed > 100) {
+            printf("FAIL warp: %zu threads, %.2f ms of warp time\n", BlockExecutor::threads.size(), warpTimeUsed);
+            failures++;
+        }
+        Scratch::warpTimeBudget = 500; // settings outlive the project they came from
+    }, 1);
+
+    check("a broadcast restarts its running receiver", [](TargetBuilder& stage, TargetBuilder& sprite) {
+        BuiltVariable a = stage.addVariable("a");
+        BuiltVariable b = stage.addVariable("b");
+        BuiltVariable c = stage.addVariable("c");
+        // the receiver is still looping when the second broadcast comes
+        sprite.script({sprite.whenFlagClicked(), sprite.broadcast("go"), sprite.repeat(number(3), sprite.changeVariable(c, number(1))),
+                       sprite.broadcast("go")});
+        sprite.script({sprite.whenIReceive("go"), sprite.changeVariable(a, number(1)), sprite.repeat(number(10), sprite.changeVariable(b, number(1)))});
+    }, [] {
+        expect("receiver started", "a", Value(2));
+        expect("loop turns", "b", Value(13));
+        if (!BlockExecutor::threadsByScript.empty()) {
+            printf("FAIL threads: %zu finished scripts still indexed\n", BlockExecutor::threadsByScript.size());
+            failures++;
+        }
+    });
+
+    check("a broadcast waits in the queue once", [](TargetBuilder& stage, TargetBuilder& sprite) {
+        BuiltVariable a = stage.addVariable("a");
+        sprite.script({sprite.whenFlagClicked(), sprite.broadcast("go"), sprite.broadcast("go")});
+        sprite.script({sprite.whenIReceive("go"), sprite.changeVariable(a, number(1))});
+        sprite.script({sprite.whenIReceive("other"), sprite.changeVariable(a, number(10))});
+    }, [] {
+        expect("sent twice in one turn", "a", Value(1));
+
+        int go = findBroadcast("go");
+        int other = findBroadcast("other");
+        broadcastQueue.resetMaxDepth();
+        broadcastQueue.push(go);
+        broadcastQueue.push(other);
+        broadcastQueue.push(go);
+        // a cancelled message keeps its slot, pushing it again puts it back in its old place
+        broadcastQueue.cancel(go);
+        broadcastQueue.push(go);
+        int first = broadcastQueue.pop();
+        int second = broadcastQueue.pop();
+        int third = broadcastQueue.pop();
+        if (first != go || second != other || third != -1) {
+            printf("FAIL ring: popped %d, %d, %d, expected %d, %d, -1\n", first, second, third, go, other);
+            failures++;
+        }
+        broadcastQueue.push(go);
+        broadcastQueue.cancel(go);
+        if (broadcastQueue.pop() != -1 || !broadcastQueue.empty()) {
+            printf("FAIL ring: a cancelled message was popped\n");
+            failures++;
+        }
+        if (broadcastQueue.getMaxDepth() != 2) {
+            printf("FAIL ring: max depth %zu, expected 2\n", broadcastQueue.getMaxDepth());
+            failures++;
+        }
+        broadcastQueue.resetMaxDepth();
+        if (broadcastQueue.getMaxDepth() != 0) {
+            printf("FAIL ring: max depth %zu after the reset\n", broadcastQueue.getMaxDepth());
+            failures++;
+        }
+    });
+
+    check("a key hat fires once per press", [](TargetBuilder& stage, TargetBuilder& sprite) {
+        BuiltVariable a = stage.addVariable("a");
+        std::string hat = sprite.block("event_whenkeypressed", {}, {{"KEY_OPTION", {"space", nullptr}}});
+        sprite.script({hat, sprite.changeVariable(a, number(1))});
+    }, [] {
+        Input::KeySet space;
+        space.set(static_cast<int>(Input::Key::SPACE));
+        for (int i = 0; i < 5; i++) tickWithKeys(space);
+        expect("held for 5 frames", "a", Value(1));
+        tickWithKeys({});
+        for (int i = 0; i < 3; i++) tickWithKeys(space);
+        tickWithKeys({});
+        expect("pressed again", "a", Value(2));
+    }, 0);
+
+    check("a clone's hats come and go with it", [](TargetBuilder& stage, TargetBuilder& sprite) {
+        BuiltVariable a = stage.addVariable("a");
+        std::string keyHat = sprite.block("event_whenkeypressed", {}, {{"KEY_OPTION", {"space", nullptr}}});
+        sprite.script({keyHat, sprite.changeVariable(a, number(1))});
+        sprite.script({sprite.whenIReceive("ping"), sprite.changeVariable(a, number(10))});
+    }, [] {
+        Sprite* original = findOriginal(findSpriteId("Sprite1"));
+        size_t originalHats = registeredHats(original);
+        Sprite* clone = createClone(*original);
+        if (registeredHats(clone) != originalHats) {
+            printf("FAIL clone: %zu hats registered, the original has %zu\n", registeredHats(clone), originalHats);
+            failures++;
+        }
+        Input::KeySet space;
+        space.set(static_cast<int>(Input::Key::SPACE));
+        tickWithKeys(space);
+        tickWithKeys({});
+        expect("both key hats ran", "a", Value(2));
+
+        deleteClone(clone);
+        tick(); // the clone is released at the end of the tick
+        if (registeredHats(clone) != 0 || registeredHats(original) != originalHats) {
+            printf("FAIL delete: %zu of the clone's hats still registered\n", registeredHats(clone));
+            failures++;
+        }
+        tickWithKeys(space);
+        tickWithKeys({});
+        expect("only the original's key hat ran", "a", Value(3));
+    }, 0);
+
+    check("sprites are found by name with their clones", [](TargetBuilder& stage, TargetBuilder& sprite) {
+    }, [] {
+        int id = findSpriteId("Sprite1");
+        Sprite* original = findOriginal(id);
+        Sprite* first = createClone(*original);
+        Sprite* second = createClone(*original);
+        std::vector<Sprite*> found = findSprite("Sprite1");
+        if (original == nullptr || original->isClone || findSpriteEntry(id)->clones.size() != 2 || found.size() != 3 || found[0] != original) {
+            printf("FAIL registry: %zu sprites named Sprite1 after making 2 clones\n", found.size());
+            failures++;
+        }
+        deleteClone(first);
+        tick();
+        found = findSprite("Sprite1");
+        if (findOriginal(id) != original || found.size() != 2 || found[1] != second) {
+            printf("FAIL registry: %zu sprites named Sprite1 after deleting a clone\n", found.size());
+            failures++;
+        }
+        if (findSpriteId("Sprite2") != -1 || findOriginal(-1) != nullptr) {
+            printf("FAIL registry: found a sprite that doesn't exist\n");
+            failures++;
+        }
+    }, 0);
+
+    check("clones stop at maxClones", [](TargetBuilder& stage, TargetBuilder& sprite) {
+        stage.addComment("{\"maxClones\": 3}");
+        BuiltVariable a = stage.addVariable("a");
+        sprite.script({sprite.whenFlagClicked(), sprite.repeat(number(10), sprite.createCloneOfMyself())});
+        sprite.script({sprite.whenStartAsClone(), sprite.changeVariable(a, number(1))});
+    }, [] {
+        expect("clones started", "a", Value(3));
+        if (clonePool.live != 3 || findSprite("Sprite1").size() != 4) {
+            printf("FAIL cap: %zu clones alive, expected 3\n", clonePool.live);
+            failures++;
+        }
+        Scratch::maxClones = 300; // settings outlive the project they came from
+    });
+
+    check("a reused clone slot doesn't run the old clone's scripts", [](TargetBuilder& stage, TargetBuilder& sprite) {
+        BuiltVariable a = stage.addVariable("a");
+        sprite.script({sprite.whenStartAsClone(), sprite.forever(sprite.changeVariable(a, number(1)))});
+    }, [] {
+        Sprite* original = findOriginal(findSpriteId("Sprite1"));
+        // what "create clone" does
+        auto spawn = [original] {
+            Sprite* clone = createClone(*original);
+            for (Block* hat : clone->shared->cloneHats) BlockExecutor::startThread(hat, clone);
+            return clone;
+        };
+        Sprite* first = spawn();
+        uint32_t generation = first->generation;
+        Headless::run(3);
+        deleteClone(first);
+        tick();
+        expect("first clone", "a", Value(3));
+
+        Sprite* second = spawn();
+        if (second != first || second->generation != generation + 1) {
+            printf("FAIL pool: the slot wasn't reused with the next generation\n");
+            failures++;
+        }
+        Headless::run(2);
+        expect("only the second clone's thread runs", "a", Value(5));
+        size_t threads = 0;
+        for (const auto& thread : BlockExecutor::threads) threads += thread->sprite == second;
+        if (threads != 1) {
+            printf("FAIL pool: %zu threads on the reused slot\n", threads);
+            failures++;
+        }
+    }, 0);
+
+    check("a clone deleted this tick isn't touched", [](TargetBuilder& stage, TargetBuilder& sprite) {
+        BuiltVariable a = stage.addVariable("a");
+        BuiltVariable b = stage.addVariable("b");
+        auto touchingItself = [&sprite] {
+            std::string target = sprite.block("sensing_touchingobjectmenu", {}, {{"TOUCHINGOBJECTMENU", {"Sprite1", nullptr}}}, nullptr, true);
+            return sprite.block("sensing_touchingobject", {{"TOUCHINGOBJECTMENU", menu(target)}});
+        };
+        // the original checks whether it touches its clone right after making it, and again once the
+        // clone deleted itself. the broadcast's receivers run after the clone's turn, in the same tick
+        sprite.script({sprite.whenFlagClicked(), sprite.createCloneOfMyself(), sprite.setVariable(a, reporter(touchingItself()))});
+        sprite.script({sprite.whenStartAsClone(), sprite.broadcast("deleted"), sprite.deleteThisClone()});
+        sprite.script({sprite.whenIReceive("deleted"), sprite.setVariable(b, reporter(touchingItself()))});
+    }, [] {
+        expect("before the clone is deleted", "a", Value(true));
+        expect("after the clone is deleted", "b", Value(false));
+    });
+
+    // unloading a project drops the masks its images stored
+    unsigned char solidPixel[4] = {0, 0, 0, 255};
+    storeCollisionMask("unloaded costume", solidPixel, 1, 1, 4);
+    Headless::stop();
+    bool masksCleared = findCollisionMask("unloaded costume") == nullptr;
+    if (!masksCleared) failures++;
+    printf("%s unloading drops the collision masks\n", masksCleared ? "PASS" : "FAIL");
+
+    if (failures > 0) {
+        printf("%d checks failed\n", failures);
+        return 1;
+    }
+    return 0;
+}